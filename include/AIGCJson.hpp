@@ -24,10 +24,74 @@
 #include <string>
 #include <iostream>
 #include <typeinfo>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <chrono>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define AIGC_JSON_HAS_MMAP 1
+#else
+#define AIGC_JSON_HAS_MMAP 0
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <optional>
+#define AIGC_JSON_HAS_COROUTINES 1
+#endif
+#endif
+#ifndef AIGC_JSON_HAS_COROUTINES
+#define AIGC_JSON_HAS_COROUTINES 0
+#endif
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<string_view>)
+#include <string_view>
+#define AIGC_JSON_HAS_STRING_VIEW 1
+#endif
+#endif
+#ifndef AIGC_JSON_HAS_STRING_VIEW
+#define AIGC_JSON_HAS_STRING_VIEW 0
+#endif
 
 #include "rapidjson/document.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/stringbuffer.h"
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/error/en.h"
 
 // #ifndef JSONHELPER_DEBUG
 // #define JSONHELPER_DEBUG
@@ -47,28 +111,38 @@ namespace aigc
  * };         
  ******************************************************/
 #define AIGC_JSON_HELPER(...)                                                                     \
+    static const std::vector<std::string> &AIGC_MEMBERS_NAMES()                                   \
+    {                                                                                             \
+        static const std::vector<std::string> names =                                             \
+            aigc::JsonHelper::GetMembersNames(#__VA_ARGS__);                                      \
+        return names;                                                                             \
+    }                                                                                             \
     bool AIGC_CONVER_JSON_TO_OBJECT(rapidjson::Value &jsonValue,                                  \
-                                    std::vector<std::string> &names)                              \
+                                    const std::vector<std::string> &names)                        \
     {                                                                                             \
-        std::vector<std::string> standardNames = aigc::JsonHelper::GetMembersNames(#__VA_ARGS__); \
-        if (names.size() <= standardNames.size())                                                 \
-        {                                                                                         \
-            for (int i = names.size(); i < standardNames.size(); i++)                             \
-                names.push_back(standardNames[i]);                                                \
-        }                                                                                         \
         return aigc::JsonHelper::WriteMembers(names, 0, jsonValue, __VA_ARGS__);                  \
     }                                                                                             \
     bool AIGC_CONVER_OBJECT_TO_JSON(rapidjson::Value &jsonValue,                                  \
                                     rapidjson::Document::AllocatorType &allocator,                \
-                                    std::vector<std::string> &names)                              \
+                                    const std::vector<std::string> &names)                        \
     {                                                                                             \
-        std::vector<std::string> standardNames = aigc::JsonHelper::GetMembersNames(#__VA_ARGS__); \
-        if (names.size() <= standardNames.size())                                                 \
-        {                                                                                         \
-            for (int i = names.size(); i < standardNames.size(); i++)                             \
-                names.push_back(standardNames[i]);                                                \
-        }                                                                                         \
         return aigc::JsonHelper::ReadMembers(names, 0, jsonValue, allocator, __VA_ARGS__);        \
+    }                                                                                             \
+    bool AIGC_CONVER_OBJECT_TO_WRITER(aigc::JsonWriter &writer,                                   \
+                                      const std::vector<std::string> &names,                      \
+                                      const std::vector<std::string> &skipNames)                  \
+    {                                                                                             \
+        if (!aigc::JsonHelper::ReadBaseMembers(*this, writer, names, skipNames))                  \
+            return false;                                                                         \
+        return aigc::JsonHelper::ReadMembers(names, 0, writer, skipNames, __VA_ARGS__);           \
+    }                                                                                             \
+    bool AIGC_CONVER_OBJECT_TO_MEMBERS(aigc::JsonMembers &members,                                \
+                                       const std::vector<std::string> &names,                     \
+                                       const std::vector<std::string> &skipNames)                 \
+    {                                                                                             \
+        if (!aigc::JsonHelper::ReadBaseMembers(*this, members, names, skipNames))                 \
+            return false;                                                                         \
+        return aigc::JsonHelper::ReadMembers(names, 0, members, skipNames, __VA_ARGS__);          \
     }
 
 /******************************************************
@@ -107,698 +181,6009 @@ namespace aigc
 #define AIGC_JSON_HELPER_BASE(...)                                                      \
     bool AIGC_BASE_CONVER_JSON_TO_OBJECT(rapidjson::Value &jsonValue)                   \
     {                                                                                   \
-        std::string jsonStr = aigc::JsonHelper::StringFromJsonValue(jsonValue);         \
-        return aigc::JsonHelper::WriteBase(jsonStr, __VA_ARGS__);                       \
+        return aigc::JsonHelper::WriteBase(jsonValue, __VA_ARGS__);                     \
     }                                                                                   \
     bool AIGC_BASE_CONVER_OBJECT_TO_JSON(rapidjson::Value &jsonValue,                   \
                                          rapidjson::Document::AllocatorType &allocator) \
     {                                                                                   \
         return aigc::JsonHelper::ReadBase(jsonValue, allocator, __VA_ARGS__);           \
+    }                                                                                   \
+    bool AIGC_BASE_CONVER_OBJECT_TO_WRITER(aigc::JsonWriter &writer,                    \
+                                           const std::vector<std::string> &skipNames)   \
+    {                                                                                   \
+        return aigc::JsonHelper::ReadBase(writer, skipNames, __VA_ARGS__);              \
+    }                                                                                   \
+    bool AIGC_BASE_CONVER_OBJECT_TO_MEMBERS(aigc::JsonMembers &members,                 \
+                                            const std::vector<std::string> &skipNames)  \
+    {                                                                                   \
+        return aigc::JsonHelper::ReadBase(members, skipNames, __VA_ARGS__);             \
     }
 
-    class JsonHelper
+    /******************************************************
+     * Output streams for the DOM-free writer
+     *      Bytes are collected in a fixed-size buffer and
+     *      handed to WriteBuffer() each time it fills up, so
+     *      the memory used does not depend on the json size.
+     * eg:
+     *      aigc::JsonFileOutputStream stream(fp);
+     *      aigc::JsonHelper::ObjectToJson(obj, stream);
+     ******************************************************/
+    class JsonOutputStream
     {
+    public:
+        typedef char Ch;
 
-    private:
-        /******************************************************
-         * Conver base-type : Json string to base-type
-         * Contain: int\uint、int64_t\uint64_t、bool、float
-         *          double、string、vector、list、map<string,XX>
-         *          
-         ******************************************************/
-        static bool JsonToObject(int &obj, rapidjson::Value &jsonValue)
+        explicit JsonOutputStream(size_t bufferSize = 64 * 1024)
+            : ownBuffer_(bufferSize > 0 ? bufferSize : 1), flushed_(0), good_(true)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsInt())
-                return false;
-            obj = jsonValue.GetInt();
-            return true;
+            begin_ = current_ = &ownBuffer_[0];
+            end_ = begin_ + ownBuffer_.size();
         }
 
-        static bool JsonToObject(unsigned int &obj, rapidjson::Value &jsonValue)
+        JsonOutputStream(char *buffer, size_t bufferSize)
+            : begin_(buffer), current_(buffer), end_(buffer + bufferSize), flushed_(0), good_(true)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsUint())
-                return false;
-            obj = jsonValue.GetUint();
-            return true;
         }
 
-        static bool JsonToObject(int64_t &obj, rapidjson::Value &jsonValue)
+        virtual ~JsonOutputStream() {}
+
+        void Put(Ch c)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsInt64())
-                return false;
-            obj = jsonValue.GetInt64();
-            return true;
+            if (current_ == end_)
+                Flush();
+            *current_++ = c;
         }
 
-        static bool JsonToObject(uint64_t &obj, rapidjson::Value &jsonValue)
+        void Flush()
         {
-            if (jsonValue.IsNull() || !jsonValue.IsUint64())
-                return false;
-            obj = jsonValue.GetUint64();
-            return true;
+            if (current_ != begin_ && good_)
+                good_ = WriteBuffer(begin_, current_ - begin_);
+            flushed_ += current_ - begin_;
+            current_ = begin_;
         }
 
-        static bool JsonToObject(bool &obj, rapidjson::Value &jsonValue)
+        void Write(const char *data, size_t size)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsBool())
-                return false;
-            obj = jsonValue.GetBool();
-            return true;
+            if (size <= size_t(end_ - current_))
+            {
+                std::memcpy(current_, data, size);
+                current_ += size;
+                return;
+            }
+            Flush();
+            if (good_)
+                good_ = WriteBuffer(data, size);
+            flushed_ += size;
         }
 
-        static bool JsonToObject(float &obj, rapidjson::Value &jsonValue)
+        // Number of bytes written so far, buffered ones included
+        size_t Tell() const { return flushed_ + (current_ - begin_); }
+
+        bool Good() const { return good_; }
+
+    protected:
+        virtual bool WriteBuffer(const char *data, size_t size) = 0;
+
+    private:
+        JsonOutputStream(const JsonOutputStream &);
+        JsonOutputStream &operator=(const JsonOutputStream &);
+
+        std::vector<char> ownBuffer_;
+        char *begin_;
+        char *current_;
+        char *end_;
+        size_t flushed_;
+        bool good_;
+    };
+
+    class JsonStringOutputStream : public JsonOutputStream
+    {
+    public:
+        explicit JsonStringOutputStream(std::string &str)
+            : JsonOutputStream(buffer_, sizeof(buffer_)), str_(str) {}
+
+    protected:
+        virtual bool WriteBuffer(const char *data, size_t size)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsNumber())
-                return false;
-            obj = jsonValue.GetFloat();
+            str_.append(data, size);
             return true;
         }
 
-        static bool JsonToObject(double &obj, rapidjson::Value &jsonValue)
+    private:
+        char buffer_[1024];
+        std::string &str_;
+    };
+
+    class JsonFileOutputStream : public JsonOutputStream
+    {
+    public:
+        explicit JsonFileOutputStream(FILE *fp, size_t bufferSize = 64 * 1024)
+            : JsonOutputStream(bufferSize), fp_(fp) {}
+
+    protected:
+        virtual bool WriteBuffer(const char *data, size_t size)
         {
-            if (jsonValue.IsNull() || !jsonValue.IsNumber())
-                return false;
-            obj = jsonValue.GetDouble();
-            return true;
+            return fp_ && std::fwrite(data, 1, size, fp_) == size;
         }
 
-        static bool JsonToObject(std::string &obj, rapidjson::Value &jsonValue)
+    private:
+        FILE *fp_;
+    };
+
+    class JsonOStreamOutputStream : public JsonOutputStream
+    {
+    public:
+        explicit JsonOStreamOutputStream(std::ostream &os, size_t bufferSize = 64 * 1024)
+            : JsonOutputStream(bufferSize), os_(os) {}
+
+    protected:
+        virtual bool WriteBuffer(const char *data, size_t size)
         {
-            obj = "";
-            if (jsonValue.IsNull())
-                return true;
-            //object or number conver to string
-            else if (jsonValue.IsObject() || jsonValue.IsNumber())
-                obj = StringFromJsonValue(jsonValue);
-            else if (!jsonValue.IsString())
-                return false;
-            else
-                obj = jsonValue.GetString();
-            return true;
+            os_.write(data, size);
+            return os_.good();
         }
 
-        template <typename TYPE>
-        static bool JsonToObject(std::vector<TYPE> &obj, rapidjson::Value &jsonValue)
-        {
-            obj.clear();
-            if (jsonValue.IsNull() || !jsonValue.IsArray())
-                return false;
+    private:
+        std::ostream &os_;
+    };
 
-            auto array = jsonValue.GetArray();
-            for (int i = 0; i < array.Size(); i++)
-            {
-                TYPE item;
-                if (!JsonToObject(item, array[i]))
-                    return false;
-                obj.push_back(item);
-            }
-            return true;
-        }
+    class JsonFdOutputStream : public JsonOutputStream
+    {
+    public:
+        explicit JsonFdOutputStream(int fd, size_t bufferSize = 64 * 1024)
+            : JsonOutputStream(bufferSize), fd_(fd) {}
 
-        template <typename TYPE>
-        static bool JsonToObject(std::list<TYPE> &obj, rapidjson::Value &jsonValue)
+    protected:
+        virtual bool WriteBuffer(const char *data, size_t size)
         {
-            obj.clear();
-            if (jsonValue.IsNull() || !jsonValue.IsArray())
-                return false;
-
-            auto array = jsonValue.GetArray();
-            for (int i = 0; i < array.Size(); i++)
+            while (size > 0)
             {
-                TYPE item;
-                if (!JsonToObject(item, array[i]))
+#ifdef _WIN32
+                int count = _write(fd_, data, (unsigned int)size);
+#else
+                ssize_t count = ::write(fd_, data, size);
+#endif
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
                     return false;
-                obj.push_back(item);
+                data += count;
+                size -= count;
             }
             return true;
         }
 
-        template <typename TYPE>
-        static bool JsonToObject(std::map<std::string, TYPE> &obj, rapidjson::Value &jsonValue)
-        {
-            obj.clear();
-            if (jsonValue.IsNull() || !jsonValue.IsObject())
-                return false;
+    private:
+        int fd_;
+    };
 
-            for (auto iter = jsonValue.MemberBegin(); iter != jsonValue.MemberEnd(); ++iter)
-            {
-                auto key = (iter->name).GetString();
-                auto &value = jsonValue[key];
+    typedef rapidjson::Writer<JsonOutputStream> JsonWriter;
 
-                TYPE item;
-                if (!JsonToObject(item, value))
-                    return false;
+    /******************************************************
+     * Input streams for readers decoding many documents
+     *      Bytes are read into a fixed-size buffer through
+     *      ReadBuffer(), memory input is used in place.
+     * eg:
+     *      aigc::JsonFileInputStream stream(fp);
+     *      aigc::JsonLinesReader<Test> reader(stream);
+     ******************************************************/
+    class JsonInputStream
+    {
+    public:
+        typedef char Ch;
 
-                obj.insert(std::pair<std::string, TYPE>(key, item));
-            }
-            return true;
+        explicit JsonInputStream(size_t bufferSize = 64 * 1024)
+            : ownBuffer_(bufferSize > 0 ? bufferSize : 1), count_(0), eof_(false)
+        {
+            begin_ = current_ = end_ = &ownBuffer_[0];
         }
 
-    private:
-        /******************************************************
-         * Conver base-type : base-type to json string
-         * Contain: int\uint、int64_t\uint64_t、bool、float
-         *          double、string、vector、list、map<string,XX>
-         *          
-         ******************************************************/
-        static bool ObjectToJson(int &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        JsonInputStream(const char *data, size_t size)
+            : begin_(data), current_(data), end_(data + size), count_(0), eof_(true)
         {
-            jsonValue.SetInt(obj);
-            return true;
         }
 
-        static bool ObjectToJson(unsigned int &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        virtual ~JsonInputStream() {}
+
+        Ch Peek()
         {
-            jsonValue.SetUint(obj);
-            return true;
+            return (current_ != end_ || Fill()) ? *current_ : '\0';
         }
 
-        static bool ObjectToJson(int64_t &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        Ch Take()
         {
-            jsonValue.SetInt64(obj);
-            return true;
+            return (current_ != end_ || Fill()) ? *current_++ : '\0';
         }
 
-        static bool ObjectToJson(uint64_t &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        size_t Tell() const { return count_ + (current_ - begin_); }
+
+        // Not implemented
+        void Put(Ch) { RAPIDJSON_ASSERT(false); }
+        void Flush() { RAPIDJSON_ASSERT(false); }
+        Ch *PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+        size_t PutEnd(Ch *) { RAPIDJSON_ASSERT(false); return 0; }
+
+        /**
+         * Buffered bytes not taken yet, Fill() reads more once
+         * they are all skipped and returns false at the end.
+         */
+        const char *Current() const { return current_; }
+        size_t Available() const { return end_ - current_; }
+        void Skip(size_t size) { current_ += size; }
+
+        bool Fill()
         {
-            jsonValue.SetUint64(obj);
-            return true;
+            if (current_ != end_)
+                return true;
+            if (eof_)
+                return false;
+
+            count_ += end_ - begin_;
+            size_t size = ReadBuffer(&ownBuffer_[0], ownBuffer_.size());
+            begin_ = current_ = &ownBuffer_[0];
+            end_ = begin_ + size;
+            eof_ = (size == 0);
+            return size > 0;
         }
 
-        static bool ObjectToJson(bool &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+    protected:
+        virtual size_t ReadBuffer(char *buffer, size_t size) = 0;
+
+    private:
+        JsonInputStream(const JsonInputStream &);
+        JsonInputStream &operator=(const JsonInputStream &);
+
+        std::vector<char> ownBuffer_;
+        const char *begin_;
+        const char *current_;
+        const char *end_;
+        size_t count_;
+        bool eof_;
+    };
+
+    class JsonMemoryInputStream : public JsonInputStream
+    {
+    public:
+        JsonMemoryInputStream(const char *data, size_t size) : JsonInputStream(data, size) {}
+
+    protected:
+        virtual size_t ReadBuffer(char *, size_t) { return 0; }
+    };
+
+    class JsonFileInputStream : public JsonInputStream
+    {
+    public:
+        explicit JsonFileInputStream(FILE *fp, size_t bufferSize = 64 * 1024)
+            : JsonInputStream(bufferSize), fp_(fp) {}
+
+    protected:
+        virtual size_t ReadBuffer(char *buffer, size_t size)
         {
-            jsonValue.SetBool(obj);
-            return true;
+            return fp_ ? std::fread(buffer, 1, size, fp_) : 0;
         }
 
-        static bool ObjectToJson(float &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+    private:
+        FILE *fp_;
+    };
+
+    class JsonIStreamInputStream : public JsonInputStream
+    {
+    public:
+        explicit JsonIStreamInputStream(std::istream &is, size_t bufferSize = 64 * 1024)
+            : JsonInputStream(bufferSize), is_(is) {}
+
+    protected:
+        virtual size_t ReadBuffer(char *buffer, size_t size)
         {
-            jsonValue.SetFloat(obj);
-            return true;
+            is_.read(buffer, size);
+            return is_.gcount();
         }
 
-        static bool ObjectToJson(double &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+    private:
+        std::istream &is_;
+    };
+
+    class JsonFdInputStream : public JsonInputStream
+    {
+    public:
+        explicit JsonFdInputStream(int fd, size_t bufferSize = 64 * 1024)
+            : JsonInputStream(bufferSize), fd_(fd) {}
+
+    protected:
+        virtual size_t ReadBuffer(char *buffer, size_t size)
         {
-            jsonValue.SetDouble(obj);
-            return true;
+            while (true)
+            {
+#ifdef _WIN32
+                int count = _read(fd_, buffer, (unsigned int)size);
+#else
+                ssize_t count = ::read(fd_, buffer, size);
+#endif
+                if (count < 0 && errno == EINTR)
+                    continue;
+                return count > 0 ? count : 0;
+            }
         }
 
-        static bool ObjectToJson(std::string &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+    private:
+        int fd_;
+    };
+
+    /******************************************************
+     * Text looked up in a hash set without copying it, for
+     * the intern tables of keys and string values
+     ******************************************************/
+    struct JsonStringKey
+    {
+        const char *data;
+        size_t length;
+        size_t hash;
+
+        // FNV-1a
+        static JsonStringKey Make(const char *data, size_t length)
         {
-            jsonValue.SetString(obj.c_str(), obj.length(), allocator);
-            return true;
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < length; i++)
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            JsonStringKey key = {data, length, static_cast<size_t>(hash ^ (hash >> 32))};
+            return key;
         }
 
-        template <typename TYPE>
-        static bool ObjectToJson(std::vector<TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        struct Hash
         {
-            rapidjson::Value array(rapidjson::Type::kArrayType);
-            for (int i = 0; i < obj.size(); i++)
-            {
-                rapidjson::Value item;
-                if (!ObjectToJson(obj[i], item, allocator))
-                    return false;
+            size_t operator()(const JsonStringKey &key) const { return key.hash; }
+        };
 
-                array.PushBack(item, allocator);
+        struct Equal
+        {
+            bool operator()(const JsonStringKey &a, const JsonStringKey &b) const
+            {
+                return a.length == b.length && std::memcmp(a.data, b.data, a.length) == 0;
             }
+        };
+    };
 
-            jsonValue = array;
-            return true;
+    /******************************************************
+     * Document whose parser stack also lives in a memory
+     * pool, so a parse can run entirely in one buffer.
+     * Its values are plain rapidjson::Value.
+     ******************************************************/
+    typedef rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>> JsonDocument;
+
+    /******************************************************
+     * Reusable parse state
+     *      Keeps one document and its memory pools between
+     *      parses, so decoding documents one after another
+     *      does not set them up again every time.
+     *      The buffer is shared by the values (3/4) and the
+     *      parser stack (1/4), only documents that outgrow
+     *      it allocate more.
+     *      With SetInternKeys(true) object keys are stored
+     *      once in the context and shared by every object
+     *      and document using them, eg. the elements of a
+     *      large array of records.
+     * eg:
+     *      char buffer[8 * 1024];
+     *      aigc::JsonParseContext context(buffer, sizeof(buffer));
+     *      aigc::JsonHelper::JsonToObject(test, data, length, context);
+     ******************************************************/
+    class JsonParseContext
+    {
+    public:
+        explicit JsonParseContext(size_t bufferSize = 64 * 1024)
+            : buffer_(bufferSize > MIN_BUFFER_SIZE ? bufferSize : MIN_BUFFER_SIZE),
+              stackCapacity_(StackSize(&buffer_[0], buffer_.size()) / 2),
+              allocator_(Begin(&buffer_[0]), ValueSize(&buffer_[0], buffer_.size())),
+              stackAllocator_(Begin(&buffer_[0]) + ValueSize(&buffer_[0], buffer_.size()), StackSize(&buffer_[0], buffer_.size())),
+              document_(&allocator_, stackCapacity_, &stackAllocator_),
+              internKeys_(false)
+        {
         }
 
-        template <typename TYPE>
-        static bool ObjectToJson(std::list<TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        /**
+         * @brief parse in caller memory, eg. an array on the stack
+         * @param buffer : at least MIN_BUFFER_SIZE bytes, must outlive the context
+         * @param bufferSize : buffer size
+         */
+        JsonParseContext(char *buffer, size_t bufferSize)
+            : stackCapacity_(StackSize(buffer, bufferSize) / 2),
+              allocator_(Begin(buffer), ValueSize(buffer, bufferSize)),
+              stackAllocator_(Begin(buffer) + ValueSize(buffer, bufferSize), StackSize(buffer, bufferSize)),
+              document_(&allocator_, stackCapacity_, &stackAllocator_),
+              internKeys_(false)
         {
-            rapidjson::Value array(rapidjson::Type::kArrayType);
-            for (auto i = obj.begin(); i != obj.end(); i++)
-            {
-                rapidjson::Value item;
-                if (!ObjectToJson(*i, item, allocator))
-                    return false;
+            RAPIDJSON_ASSERT(bufferSize >= MIN_BUFFER_SIZE);
+        }
 
-                array.PushBack(item, allocator);
+        static const size_t MIN_BUFFER_SIZE = 1024;
+        // Distinct keys kept at most, later ones are copied as usual
+        static const size_t MAX_INTERNED_KEYS = 4096;
+
+        JsonDocument &Parse(const char *data, size_t length)
+        {
+            if (internKeys_)
+            {
+                rapidjson::MemoryStream stream(data, length);
+                rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> input(stream);
+                return ParseStream<rapidjson::kParseDefaultFlags>(input);
             }
 
-            jsonValue = array;
-            return true;
+            Reset();
+            document_.Parse(data, length);
+            result_.Set(document_.GetParseError(), document_.GetErrorOffset());
+            return document_;
         }
 
-        template <typename TYPE>
-        static bool ObjectToJson(std::map<std::string, TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        template <unsigned parseFlags, typename InputStream>
+        JsonDocument &ParseStream(InputStream &stream)
         {
-            jsonValue.SetObject();
-            for (auto iter = obj.begin(); iter != obj.end(); ++iter)
+            Reset();
+            if (internKeys_)
             {
-                auto key = iter->first;
-                TYPE value = iter->second;
+                KeyGenerator<parseFlags, InputStream> generator(*this, stream);
+                document_.Populate(generator);
+                return document_;
+            }
 
-                rapidjson::Value jsonitem;
-                if (!ObjectToJson(value, jsonitem, allocator))
-                    return false;
+            document_.ParseStream<parseFlags>(stream);
+            result_.Set(document_.GetParseError(), document_.GetErrorOffset());
+            return document_;
+        }
 
-                rapidjson::Value jsonkey;
-                jsonkey.SetString(key.c_str(), key.length(), allocator);
+        /**
+         * @brief share one copy of each object key between values,
+         *        keys stay valid as long as the context
+         */
+        void SetInternKeys(bool internKeys) { internKeys_ = internKeys; }
 
-                jsonValue.AddMember(jsonkey, jsonitem, allocator);
-            }
-            return true;
+        size_t GetInternedKeyCount() const { return keys_.size(); }
+
+        JsonDocument &GetDocument() { return document_; }
+
+        void Reset()
+        {
+            // A parse that stopped early can leave values on the
+            // stack, swap in a fresh document before the pools
+            // are cleared under them
+            JsonDocument document(&allocator_, stackCapacity_, &stackAllocator_);
+            document_.Swap(document);
+            document.SetNull();
+            allocator_.Clear();
+            stackAllocator_.Clear();
+            result_.Clear();
+        }
+
+        bool HasParseError() const { return result_.IsError(); }
+
+        std::string GetErrorMessage() const
+        {
+            if (!result_.IsError())
+                return "";
+            char offset[32];
+            std::snprintf(offset, sizeof(offset), " (offset %u)", (unsigned)result_.Offset());
+            return std::string(rapidjson::GetParseError_En(result_.Code())) + offset;
         }
 
     private:
-        /******************************************************
-         * 
-         * enable_if
-         *          
-         ******************************************************/
-        template <bool, class TYPE = void>
-        struct enable_if
+        JsonParseContext(const JsonParseContext &);
+        JsonParseContext &operator=(const JsonParseContext &);
+
+        /**
+         * Passes the parser events on to the document, object
+         * keys are swapped for the context's copy so the
+         * document refers to it instead of copying the text.
+         */
+        struct KeyHandler
         {
+            KeyHandler(JsonParseContext &context, JsonDocument &document) : context(context), document(document) {}
+
+            bool Null() { return document.Null(); }
+            bool Bool(bool b) { return document.Bool(b); }
+            bool Int(int i) { return document.Int(i); }
+            bool Uint(unsigned i) { return document.Uint(i); }
+            bool Int64(int64_t i) { return document.Int64(i); }
+            bool Uint64(uint64_t i) { return document.Uint64(i); }
+            bool Double(double d) { return document.Double(d); }
+            bool RawNumber(const char *str, rapidjson::SizeType length, bool copy) { return document.RawNumber(str, length, copy); }
+            bool String(const char *str, rapidjson::SizeType length, bool copy) { return document.String(str, length, copy); }
+            bool StartObject() { return document.StartObject(); }
+            bool EndObject(rapidjson::SizeType memberCount) { return document.EndObject(memberCount); }
+            bool StartArray() { return document.StartArray(); }
+            bool EndArray(rapidjson::SizeType elementCount) { return document.EndArray(elementCount); }
+
+            bool Key(const char *str, rapidjson::SizeType length, bool copy)
+            {
+                const char *key = context.InternKey(str, length);
+                if (!key)
+                    return document.Key(str, length, copy);
+                return document.Key(key, length, false);
+            }
+
+            JsonParseContext &context;
+            JsonDocument &document;
         };
 
-        template <class TYPE>
-        struct enable_if<true, TYPE>
+        template <unsigned parseFlags, typename InputStream>
+        struct KeyGenerator
         {
-            typedef TYPE type;
+            KeyGenerator(JsonParseContext &context, InputStream &stream) : context(context), stream(stream) {}
+
+            bool operator()(JsonDocument &document)
+            {
+                KeyHandler handler(context, document);
+                rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>> reader(&context.stackAllocator_);
+                context.result_ = reader.Parse<parseFlags>(stream, handler);
+                return !context.result_.IsError();
+            }
+
+            JsonParseContext &context;
+            InputStream &stream;
         };
 
-    private:
-        /******************************************************
-         * Check AIGC_JSON_HELPER
-         *      If class or struct add AIGC_JSON_HELPER,
-         *      it will go to the correct conver function.
-         * 
-         ******************************************************/
-        template <typename T>
-        struct HasConverFunction
+        const char *InternKey(const char *str, size_t length)
         {
-            template <typename TT>
-            static char func(decltype(&TT::AIGC_CONVER_JSON_TO_OBJECT));
-            template <typename TT>
-            static int func(...);
-            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
-        };
+            JsonStringKey key = JsonStringKey::Make(str, length);
+            auto iter = keys_.find(key);
+            if (iter != keys_.end())
+                return iter->data;
+            if (keys_.size() >= MAX_INTERNED_KEYS)
+                return NULL;
 
-        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
-        static inline bool JsonToObject(T &obj, rapidjson::Value &jsonValue)
+            char *copy = static_cast<char *>(keyAllocator_.Malloc(length + 1));
+            std::memcpy(copy, str, length);
+            copy[length] = '\0';
+            key.data = copy;
+            keys_.insert(key);
+            return copy;
+        }
+
+        static const size_t ALIGNMENT = 16;
+
+        static char *Begin(char *buffer)
         {
-            if (!BaseConverJsonToObject(obj, jsonValue))
-                return false;
-            std::vector<std::string> names = LoadRenameArray(obj);
-            return obj.AIGC_CONVER_JSON_TO_OBJECT(jsonValue, names);
+            return buffer + (0 - reinterpret_cast<uintptr_t>(buffer)) % ALIGNMENT;
         }
 
-        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
-        static inline bool JsonToObject(T &obj, rapidjson::Value &jsonValue)
+        static size_t StackSize(char *buffer, size_t size)
         {
-            return false;
+            size_t usable = size - (Begin(buffer) - buffer);
+            return usable / 4 / ALIGNMENT * ALIGNMENT;
         }
 
-        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
-        static inline bool ObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        static size_t ValueSize(char *buffer, size_t size)
         {
-            if (jsonValue.IsNull())
-                jsonValue.SetObject();
-            if (!BaseConverObjectToJson(obj, jsonValue, allocator))
-                return false;
-            std::vector<std::string> names = LoadRenameArray(obj);
-            return obj.AIGC_CONVER_OBJECT_TO_JSON(jsonValue, allocator, names);
+            size_t usable = size - (Begin(buffer) - buffer);
+            return usable / ALIGNMENT * ALIGNMENT - StackSize(buffer, size);
         }
 
-        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
-        static inline bool ObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        std::vector<char> buffer_;
+        // Half the stack pool goes to the document's value stack
+        // up front, the rest is left to the reader's string stack
+        size_t stackCapacity_;
+        rapidjson::MemoryPoolAllocator<> allocator_;
+        rapidjson::MemoryPoolAllocator<> stackAllocator_;
+        JsonDocument document_;
+        rapidjson::ParseResult result_;
+        bool internKeys_;
+        // Interned keys, kept across parses
+        rapidjson::MemoryPoolAllocator<> keyAllocator_;
+        std::unordered_set<JsonStringKey, JsonStringKey::Hash, JsonStringKey::Equal> keys_;
+    };
+
+    /******************************************************
+     * Options of JsonFileToObject
+     *      useMmap    : map regular files instead of reading them,
+     *                   pipes and other files are always read
+     *      insitu     : parse in place on the private mapping
+     *      bufferSize : read buffer size when the file is not mapped
+     ******************************************************/
+    struct JsonFileOptions
+    {
+        bool useMmap;
+        bool insitu;
+        size_t bufferSize;
+
+        JsonFileOptions() : useMmap(true), insitu(true), bufferSize(64 * 1024) {}
+    };
+
+    /******************************************************
+     * Runs the tasks of the parallel decoders and writers.
+     * Implement it to run them on a pool of your own.
+     *      Execute        : run the task some time later, on
+     *                       any thread
+     *      GetConcurrency : threads the tasks may run on
+     ******************************************************/
+    class JsonExecutor
+    {
+    public:
+        virtual ~JsonExecutor() {}
+
+        virtual void Execute(const std::function<void()> &task) = 0;
+
+        virtual unsigned GetConcurrency() const = 0;
+    };
+
+    /******************************************************
+     * Work-stealing thread pool. Every worker has its own
+     * deque: tasks posted from a worker go to the back of its
+     * deque and are taken from there, idle workers steal from
+     * the front of the others.
+     * eg:
+     *      aigc::JsonThreadPool pool(4, true);
+     *      aigc::JsonParallelOptions options;
+     *      options.executor = &pool;
+     ******************************************************/
+    class JsonThreadPool : public JsonExecutor
+    {
+    public:
+        /**
+         * @param threads : worker threads, 0 for one per core
+         * @param pinThreads : bind worker i to core i (linux only)
+         */
+        explicit JsonThreadPool(unsigned threads = 0, bool pinThreads = false)
+            : pending_(0), nextQueue_(0), stop_(false)
         {
-            return false;
+            unsigned cores = std::thread::hardware_concurrency();
+            if (cores == 0)
+                cores = 1;
+            if (threads == 0)
+                threads = cores;
+
+            for (unsigned i = 0; i < threads; i++)
+                queues_.push_back(std::unique_ptr<Queue>(new Queue()));
+            for (unsigned i = 0; i < threads; i++)
+            {
+                workers_.push_back(std::thread(&JsonThreadPool::Run, this, i));
+                if (pinThreads)
+                    Pin(workers_.back(), i % cores);
+            }
         }
 
-    private:
-        /******************************************************
-         * Check AIGC_JSON_HELPER_RENAME
-         *      If class or struct add AIGC_JSON_HELPER,
-         *      it will go to the correct load rename function.
-         * 
-         ******************************************************/
-        template <typename T>
-        struct HasRenameFunction
+        // Runs the tasks left, then joins the workers
+        ~JsonThreadPool()
         {
-            template <typename TT>
-            static char func(decltype(&TT::AIGC_MEMBERS_RENAME));
-            template <typename TT>
-            static int func(...);
-            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
-        };
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_all();
+            for (size_t i = 0; i < workers_.size(); i++)
+                workers_[i].join();
+        }
 
-        template <typename T, typename enable_if<HasRenameFunction<T>::has, int>::type = 0>
-        static inline std::vector<std::string> LoadRenameArray(T &obj)
+        void Execute(const std::function<void()> &task)
         {
-            return obj.AIGC_MEMBERS_RENAME();
+            Worker &current = GetCurrentWorker();
+            size_t index = current.pool == this ? current.index : nextQueue_.fetch_add(1) % queues_.size();
+            {
+                std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+                queues_[index]->tasks.push_back(task);
+            }
+            pending_.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            condition_.notify_one();
         }
 
-        template <typename T, typename enable_if<!HasRenameFunction<T>::has, int>::type = 0>
-        static inline std::vector<std::string> LoadRenameArray(T &obj)
+        unsigned GetConcurrency() const { return (unsigned)workers_.size(); }
+
+        // Pool shared by the parallel APIs when no executor is given
+        static JsonThreadPool &GetDefault()
         {
-            return std::vector<std::string>();
+            static JsonThreadPool pool;
+            return pool;
         }
 
     private:
-        /******************************************************
-         * Check AIGC_JSON_HELPER_BASE
-         *      If class or struct add AIGC_JSON_HELPER,
-         *      it will go to the correct base conver function.
-         * 
-         ******************************************************/
-        template <typename T>
-        struct HasBaseConverFunction
-        {
-            template <typename TT>
-            static char func(decltype(&TT::AIGC_BASE_CONVER_JSON_TO_OBJECT));
-            template <typename TT>
-            static int func(...);
-            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
-        };
+        JsonThreadPool(const JsonThreadPool &);
+        JsonThreadPool &operator=(const JsonThreadPool &);
 
-        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
-        static inline bool BaseConverJsonToObject(T &obj, rapidjson::Value &jsonValue)
+        struct Queue
         {
-            return obj.AIGC_BASE_CONVER_JSON_TO_OBJECT(jsonValue);
-        }
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
 
-        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
-        static inline bool BaseConverJsonToObject(T &obj, rapidjson::Value &jsonValue)
+        struct Worker
         {
-            return true;
-        }
+            JsonThreadPool *pool;
+            size_t index;
+        };
 
-        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
-        static inline bool BaseConverObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        static Worker &GetCurrentWorker()
         {
-            return obj.AIGC_BASE_CONVER_OBJECT_TO_JSON(jsonValue, allocator);
+            static thread_local Worker worker = {NULL, 0};
+            return worker;
         }
 
-        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
-        static inline bool BaseConverObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        static void Pin(std::thread &thread, unsigned core)
         {
-            return true;
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
         }
 
-    private:
-        /******************************************************
-         * Common Tool Function, Contain:
-         * 1、String split
-         * 2、String Trim
-         * 3、Conver JsonValue to string
-         * 
-         ******************************************************/
-        static std::vector<std::string> StringSplit(const std::string &str)
+        void Run(size_t index)
         {
-            std::vector<std::string> array;
-            std::string::size_type pos1, pos2;
-            pos1 = 0;
-            pos2 = str.find(',');
-            while (std::string::npos != pos2)
+            Worker &current = GetCurrentWorker();
+            current.pool = this;
+            current.index = index;
+            while (true)
             {
-                array.push_back(str.substr(pos1, pos2 - pos1));
-                pos1 = pos2 + 1;
-                pos2 = str.find(',', pos1);
-            }
-            if (pos1 != str.length())
-                array.push_back(str.substr(pos1));
+                std::function<void()> task;
+                if (Take(index, task))
+                {
+                    pending_.fetch_sub(1);
+                    task();
+                    continue;
+                }
 
-            return array;
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!stop_ && pending_ == 0)
+                    condition_.wait(lock);
+                if (stop_ && pending_ == 0)
+                    return;
+            }
         }
 
-        static void StringTrim(std::vector<std::string> &array)
+        bool Take(size_t index, std::function<void()> &task)
         {
-            for (int i = 0; i < array.size(); i++)
             {
-                std::string newStr = array[i];
-                if (!newStr.empty())
+                Queue &own = *queues_[index];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty())
                 {
-                    newStr.erase(0, newStr.find_first_not_of(" "));
-                    newStr.erase(newStr.find_last_not_of(" ") + 1);
+                    task.swap(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
                 }
-                if (!newStr.empty())
+            }
+            for (size_t i = 1; i < queues_.size(); i++)
+            {
+                Queue &other = *queues_[(index + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                if (!other.tasks.empty())
                 {
-                    newStr.erase(0, newStr.find_first_not_of("\""));
-                    newStr.erase(newStr.find_last_not_of("\"") + 1);
+                    task.swap(other.tasks.front());
+                    other.tasks.pop_front();
+                    return true;
                 }
-                array[i] = newStr;
             }
+            return false;
         }
 
-        static std::string GetJsonValueTypeName(rapidjson::Value &jsonValue)
-        {
-            rapidjson::Type type = jsonValue.GetType();
-            switch (type)
-            {
-            case rapidjson::Type::kArrayType:
-                return "array";
-            case rapidjson::Type::kFalseType:
-            case rapidjson::Type::kTrueType:
-                return "bool";
-            case rapidjson::Type::kObjectType:
-                return "object";
-            case rapidjson::Type::kStringType:
-                return "string";
-            case rapidjson::Type::kNumberType:
-                return "number";
-            default:
-                return "string";
-            }
-        }
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::atomic<size_t> pending_;
+        std::atomic<size_t> nextQueue_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stop_;
+    };
 
-    public:
-        static std::string StringFromJsonValue(rapidjson::Value &jsonValue)
-        {
-            rapidjson::StringBuffer buffer;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    /******************************************************
+     * Options of the parallel decoders and batch conversions
+     *      threads   : threads to use, counting the calling one,
+     *                  0 for the concurrency of the executor
+     *      chunkSize : bytes given to a thread at a time, the
+     *                  chunk is extended to the next line end
+     *      maxChunks : decoded chunks held at once while waiting
+     *                  to be handed over, 0 for twice the threads
+     *      ordered   : hand records over in input order
+     *      executor  : runs the work, NULL for the shared pool
+     ******************************************************/
+    struct JsonParallelOptions
+    {
+        unsigned threads;
+        size_t chunkSize;
+        size_t maxChunks;
+        bool ordered;
+        JsonExecutor *executor;
 
-            jsonValue.Accept(writer);
-            std::string ret = std::string(buffer.GetString());
-            return ret;
+        JsonParallelOptions() : threads(0), chunkSize(1024 * 1024), maxChunks(0), ordered(true), executor(NULL) {}
+
+        JsonExecutor &GetExecutor() const
+        {
+            return executor ? *executor : JsonThreadPool::GetDefault();
         }
 
-    public:
-        /******************************************************
-         * External interface: 
-         * 
-         * a、Conver json string to class\struct:
-         *      1) T GetObjectByJson(string, bool*)
-         *      2) T GetObjectByJson(string, vector<string>, bool*)
-         *      3) bool JsonToObject(string, vector<string>)
-         * 
-         * b、Conver class\struct to json string:
-         *      1) string GetJsonByObject(T, bool*)
-         *      2) bool ObjectToJson(string, T)
-         * 
-         * c、Get last error message: GetLastErrMessage
-         * 
-         ******************************************************/
-        template <typename T>
-        static T GetObjectByJson(const std::string &jsonStr, bool *isSuccess = NULL)
+        unsigned GetThreads() const
         {
-            T obj;
-            bool check = JsonToObject(obj, jsonStr, {});
-            if (isSuccess)
-                *isSuccess = check;
-            return obj;
+            if (threads > 0)
+                return threads;
+            unsigned concurrency = GetExecutor().GetConcurrency();
+            return concurrency > 0 ? concurrency : 1;
         }
+    };
 
-        template <typename T>
-        static T GetObjectByJson(const std::string &jsonStr, std::vector<std::string> keys, bool *isSuccess = NULL)
+    /******************************************************
+     * Loops run on the calling thread together with helper
+     * tasks posted to the executor. The calling thread takes
+     * work itself rather than wait for it, so a loop finishes
+     * even when the helpers never start, eg. when the loop
+     * runs on a worker of a busy pool.
+     ******************************************************/
+    class JsonParallel
+    {
+    public:
+        /**
+         * @brief run func(i) for every i in [0, count), in any order
+         *        and on any of the threads; the first exception thrown
+         *        stops the loop and is rethrown here
+         */
+        template <typename FUNC>
+        static void For(const JsonParallelOptions &options, size_t count, FUNC func)
         {
-            T obj;
-            bool check = JsonToObject(obj, jsonStr, keys);
-            if (isSuccess)
-                *isSuccess = check;
-            return obj;
+            std::shared_ptr<ForState> state(new ForState(count));
+            state->func = [&func](size_t i) { func(i); };
+            {
+                Closer<ForState> closer(*state);
+                size_t helpers = std::min<size_t>(options.GetThreads(), count);
+                for (size_t i = 1; i < helpers; i++)
+                    options.GetExecutor().Execute([state]() {
+                        if (!state->Enter())
+                            return;
+                        state->Work();
+                        state->Leave();
+                    });
+                state->Work();
+            }
+            if (state->error)
+                std::rethrow_exception(state->error);
         }
 
         /**
-         * @brief conver json string to class | struct
-         * @param obj : class or struct or base-types
-         * @param jsonStr : json string 
-         * @param keys : obj-item keys
+         * @brief run produce(i) for every i in [0, count) on any of the
+         *        threads, and consume(i) on the calling thread in order;
+         *        at most window items are produced ahead of consume
+         * @param consume : returns false to stop
+         * @return false when consume stopped
          */
-        template <typename T>
-        static inline bool JsonToObject(T &obj, const std::string &jsonStr, std::vector<std::string> keys = {})
+        template <typename PRODUCE, typename CONSUME>
+        static bool ForOrdered(const JsonParallelOptions &options, size_t count, size_t window, PRODUCE produce, CONSUME consume)
         {
-            rapidjson::Document root;
-            root.Parse(jsonStr.c_str());
-            if (root.IsNull())
-                return false;
+            std::shared_ptr<OrderedState> state(new OrderedState(count, window > 0 ? window : 1));
+            state->produce = [&produce](size_t i) { produce(i); };
+            Closer<OrderedState> closer(*state);
 
-            rapidjson::Value value;
-            for (std::vector<std::string>::iterator it = keys.begin(); it != keys.end(); ++it)
+            size_t helpers = std::min<size_t>(options.GetThreads(), count);
+            helpers = helpers > 0 ? helpers - 1 : 0;
+            for (size_t i = 0; i < count; i++)
             {
-                const char *find = (*it).c_str();
-                if (value.IsNull())
                 {
-                    if (!root.HasMember(find))
-                        return false;
-                    value = root[find];
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    while (state->posted < helpers && state->next < state->count && state->next < state->handed + state->window)
+                    {
+                        state->posted++;
+                        lock.unlock();
+                        Post(options.GetExecutor(), state);
+                        lock.lock();
+                    }
+                    while (!state->ready[i] && !state->error)
+                    {
+                        if (state->next < state->count && state->next < state->handed + state->window)
+                        {
+                            size_t index = state->next++;
+                            lock.unlock();
+                            state->produce(index);
+                            lock.lock();
+                            state->ready[index] = 1;
+                            continue;
+                        }
+                        state->condition.wait(lock);
+                    }
+                    if (state->error)
+                        std::rethrow_exception(state->error);
                 }
-                else if (!value.IsObject() || !value.HasMember(find))
+
+                if (!consume(i))
                     return false;
-                else
-                    value = value[find];
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->handed = i + 1;
+                }
             }
-
-            if (value.IsNull())
-                return JsonToObject(obj, root);
-            else
-                return JsonToObject(obj, value);
+            return true;
         }
 
-        template <typename T>
-        static std::string GetJsonByObject(T &obj, bool *isSuccess)
+    private:
+        struct ForState
         {
-            std::string ret = "";
-            bool check = ObjectToJson(obj, ret);
-            if (isSuccess)
-                *isSuccess = check;
-            return ret;
+            std::atomic<size_t> next;
+            size_t count;
+            std::function<void(size_t)> func;
+            std::mutex mutex;
+            std::condition_variable condition;
+            size_t running;
+            bool closed;
+            std::exception_ptr error;
+
+            explicit ForState(size_t n) : next(0), count(n), running(0), closed(false) {}
+
+            bool Enter()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (closed)
+                    return false;
+                running++;
+                return true;
+            }
+
+            void Leave()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    running--;
+                }
+                condition.notify_all();
+            }
+
+            void Work()
+            {
+                try
+                {
+                    size_t i;
+                    while ((i = next.fetch_add(1)) < count)
+                        func(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = count;
+                }
+            }
+
+            // Helpers that start later find the loop closed
+            void Close()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                closed = true;
+                while (running > 0)
+                    condition.wait(lock);
+            }
+        };
+
+        struct OrderedState
+        {
+            size_t count;
+            size_t window;
+            std::function<void(size_t)> produce;
+            std::vector<char> ready;
+            std::mutex mutex;
+            std::condition_variable condition;
+            size_t next;
+            size_t handed;
+            size_t posted;
+            size_t running;
+            bool closed;
+            std::exception_ptr error;
+
+            OrderedState(size_t n, size_t w)
+                : count(n), window(w), ready(n, 0), next(0), handed(0), posted(0), running(0), closed(false) {}
+
+            void Close()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                closed = true;
+                while (running > 0)
+                    condition.wait(lock);
+            }
+        };
+
+        // Closes the loop on every exit, helpers still running keep
+        // the caller's data in use until they return
+        template <typename STATE>
+        struct Closer
+        {
+            STATE &state;
+
+            explicit Closer(STATE &s) : state(s) {}
+
+            ~Closer() { state.Close(); }
+        };
+
+        /**
+         * A helper produces until the window is full and then
+         * returns to the pool, the consumer posts it again.
+         */
+        static void Post(JsonExecutor &executor, const std::shared_ptr<OrderedState> &state)
+        {
+            executor.Execute([state]() {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                if (!state->closed)
+                {
+                    state->running++;
+                    while (!state->closed && !state->error && state->next < state->count && state->next < state->handed + state->window)
+                    {
+                        size_t index = state->next++;
+                        lock.unlock();
+                        try
+                        {
+                            state->produce(index);
+                            lock.lock();
+                            state->ready[index] = 1;
+                        }
+                        catch (...)
+                        {
+                            lock.lock();
+                            if (!state->error)
+                                state->error = std::current_exception();
+                        }
+                        state->condition.notify_all();
+                    }
+                    state->running--;
+                }
+                state->posted--;
+                lock.unlock();
+                state->condition.notify_all();
+            });
+        }
+    };
+
+    /******************************************************
+     * Numbers kept in vectors are decoded and written in a
+     * single loop instead of one overload call per element.
+     * Is/Get apply the same checks as the scalar overloads,
+     * Format writes the text rapidjson::Writer would write
+     * and returns NULL for NaN and Inf, which it rejects.
+     ******************************************************/
+    template <typename TYPE>
+    struct JsonNumber
+    {
+        static const bool IS_NUMBER = false;
+    };
+
+    template <>
+    struct JsonNumber<int>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsInt(); }
+        static int Get(const rapidjson::Value &value) { return value.GetInt(); }
+        static char *Format(int value, char *buffer, int) { return rapidjson::internal::i32toa(value, buffer); }
+    };
+
+    template <>
+    struct JsonNumber<unsigned int>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsUint(); }
+        static unsigned int Get(const rapidjson::Value &value) { return value.GetUint(); }
+        static char *Format(unsigned int value, char *buffer, int) { return rapidjson::internal::u32toa(value, buffer); }
+    };
+
+    template <>
+    struct JsonNumber<int64_t>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsInt64(); }
+        static int64_t Get(const rapidjson::Value &value) { return value.GetInt64(); }
+        static char *Format(int64_t value, char *buffer, int) { return rapidjson::internal::i64toa(value, buffer); }
+    };
+
+    template <>
+    struct JsonNumber<uint64_t>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsUint64(); }
+        static uint64_t Get(const rapidjson::Value &value) { return value.GetUint64(); }
+        static char *Format(uint64_t value, char *buffer, int) { return rapidjson::internal::u64toa(value, buffer); }
+    };
+
+    template <>
+    struct JsonNumber<double>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsNumber(); }
+        static double Get(const rapidjson::Value &value) { return value.GetDouble(); }
+        static char *Format(double value, char *buffer, int maxDecimalPlaces)
+        {
+            if (rapidjson::internal::Double(value).IsNanOrInf())
+                return NULL;
+            return rapidjson::internal::dtoa(value, buffer, maxDecimalPlaces);
         }
+    };
+
+    template <>
+    struct JsonNumber<float>
+    {
+        static const bool IS_NUMBER = true;
+        static bool Is(const rapidjson::Value &value) { return value.IsNumber(); }
+        static float Get(const rapidjson::Value &value) { return value.GetFloat(); }
+        static char *Format(float value, char *buffer, int maxDecimalPlaces) { return JsonNumber<double>::Format(value, buffer, maxDecimalPlaces); }
+    };
+
+    /******************************************************
+     * Nested number arrays, eg. [[x,y],[x,y]] or rows of
+     * samples, kept in one buffer plus the offset of each row
+     * instead of a vector per row. Rows may differ in length
+     * unless a column count is set, in which case a row of
+     * any other length fails the decoding.
+     * eg:
+     *      aigc::JsonMatrix<double> points(2);
+     *      aigc::JsonHelper::JsonToObject(points, "[[1,2],[3,4]]");
+     *      double y = points[1][1];
+     ******************************************************/
+    template <typename TYPE>
+    class JsonMatrix
+    {
+        static_assert(JsonNumber<TYPE>::IS_NUMBER, "JsonMatrix only holds numbers");
 
+    public:
         /**
-         * @brief conver class | struct to json string
-         * @param obj : class or struct
-         * @param jsonStr : json string 
+         * @param columns : length of every row, 0 lets rows differ
          */
-        template <typename T>
-        static inline bool ObjectToJson(T &obj, std::string &jsonStr)
+        explicit JsonMatrix(size_t columns = 0) : offsets_(1, 0), columns_(columns) {}
+
+        size_t GetRowCount() const { return offsets_.size() - 1; }
+        size_t GetRowSize(size_t row) const { return offsets_[row + 1] - offsets_[row]; }
+
+        size_t GetColumns() const { return columns_; }
+        void SetColumns(size_t columns) { columns_ = columns; }
+
+        bool IsRectangular() const
         {
-            rapidjson::Document root;
-            root.SetObject();
-            rapidjson::Document::AllocatorType &allocator = root.GetAllocator();
+            for (size_t i = 1; i < GetRowCount(); i++)
+            {
+                if (GetRowSize(i) != GetRowSize(0))
+                    return false;
+            }
+            return true;
+        }
 
-            if (!ObjectToJson(obj, root, allocator))
-                return false;
+        TYPE *operator[](size_t row) { return data_.data() + offsets_[row]; }
+        const TYPE *operator[](size_t row) const { return data_.data() + offsets_[row]; }
 
-            jsonStr = StringFromJsonValue(root);
+        // Elements of all rows, one row after another
+        const std::vector<TYPE> &GetData() const { return data_; }
+        // Start of each row in GetData(), followed by its size
+        const std::vector<size_t> &GetOffsets() const { return offsets_; }
+
+        bool AddRow(const TYPE *values, size_t size)
+        {
+            if (columns_ > 0 && size != columns_)
+                return false;
+            data_.insert(data_.end(), values, values + size);
+            offsets_.push_back(data_.size());
             return true;
         }
 
+        void Clear()
+        {
+            data_.clear();
+            offsets_.assign(1, 0);
+        }
+
+    private:
+        friend class JsonHelper;
+
+        std::vector<TYPE> data_;
+        std::vector<size_t> offsets_;
+        size_t columns_;
+    };
+
+    /******************************************************
+     * Registered members of an object in writer order, for
+     * encoders that walk the member graph themselves
+     * instead of recursing (see JsonStepEncoder).
+     ******************************************************/
+    class JsonStepEncoder;
+
+    template <typename TYPE>
+    struct JsonStepValue;
+
+    struct JsonMember
+    {
+        const std::string *name;
+        void *value;
+        bool (*push)(JsonStepEncoder &encoder, void *value);
+    };
+
+    typedef std::vector<JsonMember> JsonMembers;
+
+    template <typename T>
+    class Lazy;
+
+    template <typename T>
+    class Interned;
+
+    /******************************************************
+     * Member kept as json text, for payloads that are only
+     * forwarded. Decoding from text in memory (json string,
+     * JsonParseContext, json lines, mapped files) keeps the
+     * exact source bytes; stream and in-situ decodes have no
+     * text left to point at and keep the value written back
+     * by rapidjson instead. The text must be valid json, it
+     * is checked and spliced into the output as it is, an
+     * empty one is written as null.
+     * eg:
+     * struct Test
+     * {
+     *      string A;
+     *      aigc::RawJson B;
+     *      AIGC_JSON_HELPER(A, B)
+     * };
+     ******************************************************/
+    struct RawJson
+    {
+        RawJson() {}
+        RawJson(const std::string &json) : json(json) {}
+
+        std::string json;
+    };
+
+    /******************************************************
+     * Values being decoded on this thread, innermost first
+     ******************************************************/
+    struct JsonValueFrame
+    {
+        const rapidjson::Value *value;
+        const JsonValueFrame *parent;
+    };
+
+    /******************************************************
+     * Finds the text a value of a parsed document came from.
+     *      The document keeps member order, so a value is
+     *      found from its index in the container holding it,
+     *      which the frames of the decoder lead to. The start
+     *      of each container on the current path and of its
+     *      last child found are kept, so siblings decoded in
+     *      order are not scanned again.
+     *      The text must be what the document was parsed from
+     *      with the default flags.
+     ******************************************************/
+    class JsonSourceMap
+    {
     public:
-        /******************************************************
-         * Cycle conversion:
-         *      1) write class\struct members from json value
-         *      2) read class\struct members to json value
-         *      3) write class\struct base-class
-         *      4) read class\struct base-class
-         * 
-         ******************************************************/
-        static std::vector<std::string> GetMembersNames(const std::string membersStr)
+        JsonSourceMap(const char *data, size_t length, const rapidjson::Value &root)
+            : begin_(data), end_(data + length), root_(&root)
         {
-            std::vector<std::string> array = StringSplit(membersStr);
-            StringTrim(array);
-            return array;
         }
 
-        template <typename TYPE, typename... TYPES>
-        static bool WriteMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, TYPE &arg, TYPES &... args)
+        /**
+         * @brief source text of a value of the document
+         * @param value : value being decoded
+         * @param frame : frames of the decoder, innermost first
+         * @return false if the value is not part of the document
+         */
+        bool Find(const rapidjson::Value &value, const JsonValueFrame *frame, const char *&data, size_t &length)
         {
-            if (!WriteMembers(names, index, jsonValue, arg))
+            if (!begin_)
                 return false;
-            return WriteMembers(names, ++index, jsonValue, args...);
+
+            size_t level;
+            const char *start = Start(&value, frame, level);
+            if (!start)
+                return false;
+            data = start;
+            length = SkipValue(start) - start;
+            return true;
         }
 
-        template <typename TYPE>
-        static bool WriteMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, TYPE &arg)
+    private:
+        typedef rapidjson::Value::Member Member;
+
+        struct Level
         {
-            const char *key = names[index].c_str();
-            if (jsonValue.IsNull())
-                return true;
-            if (!jsonValue.IsObject())
-                return false;
-            if (!jsonValue.HasMember(key))
-                return true;
+            const rapidjson::Value *container;
+            const char *start;
+            // Last child found
+            const char *cursor;
+            size_t cursorIndex;
+        };
+
+        const char *Start(const rapidjson::Value *value, const JsonValueFrame *frame, size_t &level)
+        {
+            if (value == root_)
+            {
+                Level root = {root_, SkipWhitespace(begin_), NULL, 0};
+                if (levels_.empty() || levels_[0].container != root_)
+                    levels_.assign(1, root);
+                level = 0;
+                return levels_[0].start;
+            }
+            for (size_t i = 0; i < levels_.size(); i++)
+            {
+                if (levels_[i].container == value)
+                {
+                    level = i;
+                    return levels_[i].start;
+                }
+            }
 
-            bool check = JsonToObject(arg, jsonValue[key]);
+            while (frame && frame->value == value)
+                frame = frame->parent;
+            const rapidjson::Value *parent = frame ? frame->value : root_;
+            size_t parentLevel;
+            if (!Start(parent, frame ? frame->parent : NULL, parentLevel))
+                return NULL;
 
-            PrintJsonToObject(jsonValue[key], names[index], check);
-            return check;
+            size_t index;
+            if (ChildIndex(*parent, value, index))
+                return Enter(parentLevel, value, Child(parentLevel, index), level);
+
+            // not a child of the frame, eg. reached through keys, search below it
+            return Search(parentLevel, value, level);
         }
 
-        template <typename TYPE, typename... TYPES>
-        static bool ReadMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE &arg, TYPES &... args)
+        const char *Enter(size_t parentLevel, const rapidjson::Value *value, const char *start, size_t &level)
         {
-            if (!ReadMembers(names, index, jsonValue, allocator, arg))
-                return false;
-            return ReadMembers(names, ++index, jsonValue, allocator, args...);
+            level = parentLevel + 1;
+            if (value->IsObject() || value->IsArray())
+            {
+                Level entry = {value, start, NULL, 0};
+                levels_.resize(level);
+                levels_.push_back(entry);
+            }
+            return start;
         }
 
-        template <typename TYPE>
-        static bool ReadMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE &arg)
+        const char *Search(size_t parentLevel, const rapidjson::Value *value, size_t &level)
         {
-            rapidjson::Value item;
-            bool check = ObjectToJson(arg, item, allocator);
+            const rapidjson::Value *parent = levels_[parentLevel].container;
+            size_t size = parent->IsObject() ? parent->MemberCount() : parent->Size();
+            for (size_t i = 0; i < size; i++)
+            {
+                const rapidjson::Value *child = parent->IsObject() ? &(parent->MemberBegin() + i)->value : parent->Begin() + i;
+                if (child == value)
+                    return Enter(parentLevel, value, Child(parentLevel, i), level);
+                if (Contains(*child, value))
+                {
+                    size_t childLevel;
+                    Enter(parentLevel, child, Child(parentLevel, i), childLevel);
+                    return Search(childLevel, value, level);
+                }
+            }
+            return NULL;
+        }
 
-            PrintObjectToJson(names[index], check);
-            if (!check)
-                return false;
+        static bool Contains(const rapidjson::Value &container, const rapidjson::Value *value)
+        {
+            if (container.IsObject())
+            {
+                for (auto iter = container.MemberBegin(); iter != container.MemberEnd(); ++iter)
+                {
+                    if (&iter->value == value || Contains(iter->value, value))
+                        return true;
+                }
+            }
+            else if (container.IsArray())
+            {
+                for (auto iter = container.Begin(); iter != container.End(); ++iter)
+                {
+                    if (iter == value || Contains(*iter, value))
+                        return true;
+                }
+            }
+            return false;
+        }
 
-            if (jsonValue.HasMember(names[index].c_str()))
+        static bool ChildIndex(const rapidjson::Value &parent, const rapidjson::Value *value, size_t &index)
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(value);
+            if (parent.IsObject() && parent.MemberCount() > 0)
             {
-                jsonValue.RemoveMember(names[index].c_str());
+                uintptr_t begin = reinterpret_cast<uintptr_t>(&*parent.MemberBegin());
+                if (address < begin || address >= begin + parent.MemberCount() * sizeof(Member))
+                    return false;
+                index = (address - begin) / sizeof(Member);
+                return value == &(parent.MemberBegin() + index)->value;
+            }
+            if (parent.IsArray() && parent.Size() > 0)
+            {
+                uintptr_t begin = reinterpret_cast<uintptr_t>(parent.Begin());
+                if (address < begin || address >= begin + parent.Size() * sizeof(rapidjson::Value))
+                    return false;
+                index = (address - begin) / sizeof(rapidjson::Value);
+                return value == parent.Begin() + index;
             }
+            return false;
+        }
 
-            rapidjson::Value key;
-            key.SetString(names[index].c_str(), names[index].length(), allocator);
-            jsonValue.AddMember(key, item, allocator);
-            return true;
+        const char *Child(size_t level, size_t index)
+        {
+            Level &parent = levels_[level];
+            bool object = parent.container->IsObject();
+            const char *p;
+            size_t i;
+            if (parent.cursor && parent.cursorIndex <= index)
+            {
+                p = parent.cursor;
+                i = parent.cursorIndex;
+            }
+            else
+            {
+                p = ChildValue(SkipWhitespace(parent.start + 1), object);
+                i = 0;
+            }
+
+            for (; i < index; i++)
+            {
+                // skip the value and the comma after it
+                p = SkipWhitespace(SkipValue(p));
+                p = ChildValue(SkipWhitespace(p + 1), object);
+            }
+            parent.cursor = p;
+            parent.cursorIndex = i;
+            return p;
         }
 
-        template <typename TYPE, typename... TYPES>
-        static bool WriteBase(const std::string &sjson, TYPE *arg, TYPES *... args)
+        // Skips the key of a member, p is at the start of a child
+        const char *ChildValue(const char *p, bool object) const
         {
-            if (!WriteBase(sjson, arg))
-                return false;
-            return WriteBase(sjson, args...);
+            if (!object)
+                return p;
+            p = SkipWhitespace(SkipString(p));
+            return SkipWhitespace(p + 1);
         }
 
-        template <typename TYPE>
-        static bool WriteBase(const std::string &sjson, TYPE *arg)
+        const char *SkipWhitespace(const char *p) const
         {
-            return aigc::JsonHelper::JsonToObject(*arg, sjson);
+            while (p < end_ && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+                p++;
+            return p;
         }
 
-        template <typename TYPE, typename... TYPES>
-        static bool ReadBase(rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE *arg, TYPES *... args)
+        static const char *SkipString(const char *p)
         {
-            if (!ReadBase(jsonValue, allocator, arg))
-                return false;
-            return ReadBase(jsonValue, allocator, args...);
+            for (p++; *p != '"'; p++)
+            {
+                if (*p == '\\')
+                    p++;
+            }
+            return p + 1;
         }
 
-        template <typename TYPE>
-        static bool ReadBase(rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE *arg)
+        const char *SkipValue(const char *p) const
         {
-            return aigc::JsonHelper::ObjectToJson(*arg, jsonValue, allocator);
+            if (*p == '"')
+                return SkipString(p);
+
+            if (*p != '{' && *p != '[')
+            {
+                while (p < end_ && !std::strchr(",]} \n\r\t", *p))
+                    p++;
+                return p;
+            }
+
+            // '[' and ']' differ from '{' and '}' by bit 0x20 only
+            int depth = 0;
+            do
+            {
+                char c = *p | 0x20;
+                if (c == '{')
+                    depth++;
+                else if (c == '}')
+                    depth--;
+                else if (*p == '"')
+                {
+                    p = SkipString(p);
+                    continue;
+                }
+                p++;
+            } while (depth > 0);
+            return p;
         }
 
-    private:
-        /******************************************************
-         * 
-         * Print debug-message:
-         * 
-         ******************************************************/
-        static void PrintJsonToObject(rapidjson::Value &jsonValue, const std::string &name, bool success)
+        const char *begin_;
+        const char *end_;
+        const rapidjson::Value *root_;
+        std::vector<Level> levels_;
+    };
+
+    /******************************************************
+     * String member pointing into the buffer handed to
+     * JsonHelper::JsonToObjectInsitu, valid as long as that
+     * buffer is. Other decodes fail for it, since their text
+     * is gone when they return. With JSONHELPER_DEBUG a copy
+     * is kept and Data() reports text that changed under it.
+     * That is a best-effort check for an overwritten buffer,
+     * not for a freed one: reading freed memory is undefined
+     * and may well still show the old text.
+     * eg:
+     * struct Test
+     * {
+     *      aigc::StringRef A;
+     *      AIGC_JSON_HELPER(A)
+     * };
+     ******************************************************/
+    class StringRef
+    {
+    public:
+        StringRef() : data_(""), length_(0) {}
+
+        StringRef(const char *data, size_t length) : data_(data), length_(length)
         {
 #ifdef JSONHELPER_DEBUG
-            std::string jsonType = GetJsonValueTypeName(jsonValue);
-            std::string flag = success ? "[SUCCESS] " : "[ERROR] ";
-            std::string value = "jsonValue-" + jsonType + " --> " + name;
-            std::cout << flag + value << std::endl;
+            copy_.assign(data, length);
 #endif // DEBUG
         }
 
-        static void PrintObjectToJson(const std::string &name, bool success)
+        const char *Data() const
         {
 #ifdef JSONHELPER_DEBUG
-            std::string flag = success ? "[SUCCESS] " : "[ERROR] ";
-            std::string value = name + " --> jsonValue";
-            std::cout << flag + value << std::endl;
+            if (copy_.compare(0, copy_.length(), data_, length_) != 0)
+                std::cout << "[ERROR] StringRef buffer was overwritten: " + copy_ << std::endl;
 #endif // DEBUG
+            return data_;
         }
+
+        size_t Length() const { return length_; }
+
+        std::string ToString() const { return std::string(Data(), length_); }
+
+    private:
+        const char *data_;
+        size_t length_;
+#ifdef JSONHELPER_DEBUG
+        std::string copy_;
+#endif // DEBUG
+    };
+
+    class JsonHelper
+    {
+    public:
+        static const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+    private:
+        /******************************************************
+         * Conver base-type : Json string to base-type
+         * Contain: int\uint、int64_t\uint64_t、bool、float
+         *          double、string、vector、list、map<string,XX>
+         *          
+         ******************************************************/
+        static bool JsonToObject(int &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsInt())
+                return false;
+            obj = jsonValue.GetInt();
+            return true;
+        }
+
+        static bool JsonToObject(unsigned int &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsUint())
+                return false;
+            obj = jsonValue.GetUint();
+            return true;
+        }
+
+        static bool JsonToObject(int64_t &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsInt64())
+                return false;
+            obj = jsonValue.GetInt64();
+            return true;
+        }
+
+        static bool JsonToObject(uint64_t &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsUint64())
+                return false;
+            obj = jsonValue.GetUint64();
+            return true;
+        }
+
+        static bool JsonToObject(bool &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsBool())
+                return false;
+            obj = jsonValue.GetBool();
+            return true;
+        }
+
+        static bool JsonToObject(float &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsNumber())
+                return false;
+            obj = jsonValue.GetFloat();
+            return true;
+        }
+
+        static bool JsonToObject(double &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsNumber())
+                return false;
+            obj = jsonValue.GetDouble();
+            return true;
+        }
+
+        /**
+         * Strings and containers take any allocator, eg. std::pmr ones.
+         * Elements are decoded in place, so they are built with the
+         * container's allocator and no temporary is copied in.
+         */
+        template <typename TRAITS, typename ALLOC>
+        static bool JsonToObject(std::basic_string<char, TRAITS, ALLOC> &obj, rapidjson::Value &jsonValue)
+        {
+            obj.clear();
+            if (jsonValue.IsNull())
+                return true;
+            //object or number conver to string
+            else if (jsonValue.IsObject() || jsonValue.IsNumber())
+            {
+                std::string str = StringFromJsonValue(jsonValue);
+                obj.assign(str.c_str(), str.length());
+            }
+            else if (!jsonValue.IsString())
+                return false;
+            else
+                obj.assign(jsonValue.GetString(), jsonValue.GetStringLength());
+            return true;
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool JsonToObject(std::vector<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull() || !jsonValue.IsArray())
+            {
+                obj.clear();
+                return false;
+            }
+
+            return ArrayToVector(obj, jsonValue, std::integral_constant<bool, JsonNumber<TYPE>::IS_NUMBER>());
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool ArrayToVector(std::vector<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue, std::false_type)
+        {
+            auto array = jsonValue.GetArray();
+            //a recycled vector decodes into the elements it already has
+            if (RecycleMode())
+            {
+                obj.resize(array.Size());
+                for (rapidjson::SizeType i = 0; i < array.Size(); i++)
+                {
+                    ValueFrame frame(array[i]);
+                    if (!RecycleElement(obj[i], array[i]))
+                    {
+                        obj.resize(i + 1);
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            obj.clear();
+            obj.reserve(array.Size());
+            for (auto iter = array.Begin(); iter != array.End(); ++iter)
+            {
+                obj.emplace_back();
+                ValueFrame frame(*iter);
+                if (!JsonToObject(obj.back(), *iter))
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * Numbers are stored straight into the vector's buffer, 
+         * which is sized once up front.
+         */
+        template <typename TYPE, typename ALLOC>
+        static bool ArrayToVector(std::vector<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue, std::true_type)
+        {
+            const rapidjson::Value *items = jsonValue.Begin();
+            rapidjson::SizeType size = jsonValue.Size();
+            obj.resize(size);
+
+            TYPE *data = obj.data();
+            for (rapidjson::SizeType i = 0; i < size; i++)
+            {
+                if (!JsonNumber<TYPE>::Is(items[i]))
+                {
+                    obj.resize(i + 1);
+                    return false;
+                }
+                data[i] = JsonNumber<TYPE>::Get(items[i]);
+            }
+            return true;
+        }
+
+        template <typename TYPE>
+        static bool JsonToObject(JsonMatrix<TYPE> &obj, rapidjson::Value &jsonValue)
+        {
+            obj.Clear();
+            if (jsonValue.IsNull() || !jsonValue.IsArray())
+                return false;
+
+            // rows are checked first so the buffer is sized once
+            auto rows = jsonValue.GetArray();
+            size_t size = 0;
+            for (auto row = rows.Begin(); row != rows.End(); ++row)
+            {
+                if (!row->IsArray() || (obj.columns_ > 0 && row->Size() != obj.columns_))
+                    return false;
+                size += row->Size();
+            }
+
+            obj.data_.resize(size);
+            obj.offsets_.reserve(rows.Size() + 1);
+            TYPE *data = obj.data_.data();
+            for (auto row = rows.Begin(); row != rows.End(); ++row)
+            {
+                for (auto item = row->Begin(); item != row->End(); ++item)
+                {
+                    if (!JsonNumber<TYPE>::Is(*item))
+                    {
+                        obj.Clear();
+                        return false;
+                    }
+                    *data++ = JsonNumber<TYPE>::Get(*item);
+                }
+                obj.offsets_.push_back(data - obj.data_.data());
+            }
+            return true;
+        }
+
+        // Missing members of a recycled element are reset from a prototype of its own type
+        template <typename TYPE>
+        static bool RecycleElement(TYPE &obj, rapidjson::Value &jsonValue)
+        {
+            RecycleScope<TYPE> scope(obj);
+            return JsonToObject(obj, jsonValue);
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool JsonToObject(std::list<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue)
+        {
+            if (!RecycleMode())
+                obj.clear();
+            if (jsonValue.IsNull() || !jsonValue.IsArray())
+            {
+                obj.clear();
+                return false;
+            }
+
+            //a recycled list decodes into the elements it already has
+            auto array = jsonValue.GetArray();
+            obj.resize(array.Size());
+            auto item = obj.begin();
+            for (auto iter = array.Begin(); iter != array.End(); ++iter, ++item)
+            {
+                ValueFrame frame(*iter);
+                bool check = RecycleMode() ? RecycleElement(*item, *iter) : JsonToObject(*item, *iter);
+                if (!check)
+                {
+                    obj.erase(++item, obj.end());
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename TRAITS, typename KEYALLOC, typename TYPE, typename COMPARE, typename ALLOC>
+        static bool JsonToObject(std::map<std::basic_string<char, TRAITS, KEYALLOC>, TYPE, COMPARE, ALLOC> &obj, rapidjson::Value &jsonValue)
+        {
+            obj.clear();
+            if (jsonValue.IsNull() || !jsonValue.IsObject())
+                return false;
+
+            for (auto iter = jsonValue.MemberBegin(); iter != jsonValue.MemberEnd(); ++iter)
+            {
+                //the first of repeated keys wins
+                auto item = obj.emplace(std::piecewise_construct,
+                                        std::forward_as_tuple(iter->name.GetString(), iter->name.GetStringLength()),
+                                        std::forward_as_tuple());
+                if (!item.second)
+                    continue;
+
+                ValueFrame frame(iter->value);
+                if (!JsonToObject(item.first->second, iter->value))
+                    return false;
+            }
+            return true;
+        }
+
+        static bool JsonToObject(StringRef &obj, rapidjson::Value &jsonValue)
+        {
+            if (!jsonValue.IsString() || !InInsituBuffer(jsonValue.GetString(), jsonValue.GetStringLength()))
+                return false;
+            obj = StringRef(jsonValue.GetString(), jsonValue.GetStringLength());
+            return true;
+        }
+
+#if AIGC_JSON_HAS_STRING_VIEW
+        static bool JsonToObject(std::string_view &obj, rapidjson::Value &jsonValue)
+        {
+            if (!jsonValue.IsString() || !InInsituBuffer(jsonValue.GetString(), jsonValue.GetStringLength()))
+                return false;
+            obj = std::string_view(jsonValue.GetString(), jsonValue.GetStringLength());
+            return true;
+        }
+#endif
+
+        template <typename TYPE>
+        static bool JsonToObject(Interned<TYPE> &obj, rapidjson::Value &jsonValue)
+        {
+            if (jsonValue.IsNull())
+                obj = Interned<TYPE>();
+            else if (!jsonValue.IsString())
+                return false;
+            else
+                obj = Interned<TYPE>(jsonValue.GetString(), jsonValue.GetStringLength());
+            return true;
+        }
+
+        static bool JsonToObject(RawJson &obj, rapidjson::Value &jsonValue)
+        {
+            obj.json = SourceText(jsonValue);
+            return true;
+        }
+
+        template <typename TYPE>
+        static bool JsonToObject(Lazy<TYPE> &obj, rapidjson::Value &jsonValue)
+        {
+            obj.SetRaw(SourceText(jsonValue), jsonValue.GetType());
+            return true;
+        }
+
+        // The bytes a value was parsed from, or the value written back when they are gone
+        static std::string SourceText(rapidjson::Value &jsonValue)
+        {
+            const char *data;
+            size_t length;
+            JsonSourceMap *source = CurrentSource();
+            if (source && source->Find(jsonValue, CurrentFrame(), data, length))
+                return std::string(data, length);
+            return StringFromJsonValue(jsonValue);
+        }
+
+    private:
+        /******************************************************
+         * Conver base-type : base-type to json string
+         * Contain: int\uint、int64_t\uint64_t、bool、float
+         *          double、string、vector、list、map<string,XX>
+         *          
+         ******************************************************/
+        static bool ObjectToJson(int &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetInt(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(unsigned int &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetUint(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(int64_t &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetInt64(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(uint64_t &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetUint64(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(bool &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetBool(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(float &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetFloat(obj);
+            return true;
+        }
+
+        static bool ObjectToJson(double &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetDouble(obj);
+            return true;
+        }
+
+        template <typename TRAITS, typename ALLOC>
+        static bool ObjectToJson(std::basic_string<char, TRAITS, ALLOC> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetString(obj.c_str(), obj.length(), allocator);
+            return true;
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool ObjectToJson(std::vector<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            rapidjson::Value array(rapidjson::Type::kArrayType);
+            array.Reserve(static_cast<rapidjson::SizeType>(obj.size()), allocator);
+            for (int i = 0; i < obj.size(); i++)
+            {
+                rapidjson::Value item;
+                if (!ObjectToJson(obj[i], item, allocator))
+                    return false;
+
+                array.PushBack(item, allocator);
+            }
+
+            jsonValue = array;
+            return true;
+        }
+
+        template <typename TYPE>
+        static bool ObjectToJson(JsonMatrix<TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            rapidjson::Value rows(rapidjson::Type::kArrayType);
+            rows.Reserve(static_cast<rapidjson::SizeType>(obj.GetRowCount()), allocator);
+            for (size_t i = 0; i < obj.GetRowCount(); i++)
+            {
+                TYPE *data = obj[i];
+                rapidjson::Value row(rapidjson::Type::kArrayType);
+                row.Reserve(static_cast<rapidjson::SizeType>(obj.GetRowSize(i)), allocator);
+                for (size_t j = 0; j < obj.GetRowSize(i); j++)
+                {
+                    rapidjson::Value item;
+                    if (!ObjectToJson(data[j], item, allocator))
+                        return false;
+
+                    row.PushBack(item, allocator);
+                }
+                rows.PushBack(row, allocator);
+            }
+
+            jsonValue = rows;
+            return true;
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool ObjectToJson(std::list<TYPE, ALLOC> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            rapidjson::Value array(rapidjson::Type::kArrayType);
+            for (auto i = obj.begin(); i != obj.end(); i++)
+            {
+                rapidjson::Value item;
+                if (!ObjectToJson(*i, item, allocator))
+                    return false;
+
+                array.PushBack(item, allocator);
+            }
+
+            jsonValue = array;
+            return true;
+        }
+
+        template <typename TRAITS, typename KEYALLOC, typename TYPE, typename COMPARE, typename ALLOC>
+        static bool ObjectToJson(std::map<std::basic_string<char, TRAITS, KEYALLOC>, TYPE, COMPARE, ALLOC> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetObject();
+            for (auto iter = obj.begin(); iter != obj.end(); ++iter)
+            {
+                auto &key = iter->first;
+
+                rapidjson::Value jsonitem;
+                if (!ObjectToJson(iter->second, jsonitem, allocator))
+                    return false;
+
+                rapidjson::Value jsonkey;
+                jsonkey.SetString(key.c_str(), key.length(), allocator);
+
+                jsonValue.AddMember(jsonkey, jsonitem, allocator);
+            }
+            return true;
+        }
+
+        static bool ObjectToJson(StringRef &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetString(obj.Data(), obj.Length(), allocator);
+            return true;
+        }
+
+#if AIGC_JSON_HAS_STRING_VIEW
+        static bool ObjectToJson(std::string_view &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetString(obj.data(), obj.length(), allocator);
+            return true;
+        }
+#endif
+
+        template <typename TYPE>
+        static bool ObjectToJson(Interned<TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            jsonValue.SetString(obj.Get().c_str(), obj.Get().length(), allocator);
+            return true;
+        }
+
+        static bool ObjectToJson(RawJson &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            if (obj.json.empty())
+            {
+                jsonValue.SetNull();
+                return true;
+            }
+
+            rapidjson::Document doc(&allocator);
+            doc.Parse(obj.json.c_str(), obj.json.length());
+            if (doc.HasParseError())
+                return false;
+            jsonValue.Swap(doc);
+            return true;
+        }
+
+        template <typename TYPE>
+        static bool ObjectToJson(Lazy<TYPE> &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            std::string raw = obj.GetRaw();
+            if (raw.empty())
+                return ObjectToJson(obj.Get(), jsonValue, allocator);
+
+            rapidjson::Document doc(&allocator);
+            doc.Parse(raw.c_str(), raw.length());
+            if (doc.HasParseError())
+                return false;
+            jsonValue.Swap(doc);
+            return true;
+        }
+
+    private:
+        /******************************************************
+         * Conver base-type : base-type to json writer
+         * Contain: int\uint、int64_t\uint64_t、bool、float
+         *          double、string、vector、list、map<string,XX>
+         *          
+         ******************************************************/
+        static bool ObjectToJson(int &obj, JsonWriter &writer)
+        {
+            return writer.Int(obj);
+        }
+
+        static bool ObjectToJson(unsigned int &obj, JsonWriter &writer)
+        {
+            return writer.Uint(obj);
+        }
+
+        static bool ObjectToJson(int64_t &obj, JsonWriter &writer)
+        {
+            return writer.Int64(obj);
+        }
+
+        static bool ObjectToJson(uint64_t &obj, JsonWriter &writer)
+        {
+            return writer.Uint64(obj);
+        }
+
+        static bool ObjectToJson(bool &obj, JsonWriter &writer)
+        {
+            return writer.Bool(obj);
+        }
+
+        static bool ObjectToJson(float &obj, JsonWriter &writer)
+        {
+            return writer.Double(obj);
+        }
+
+        static bool ObjectToJson(double &obj, JsonWriter &writer)
+        {
+            return writer.Double(obj);
+        }
+
+        template <typename TRAITS, typename ALLOC>
+        static bool ObjectToJson(std::basic_string<char, TRAITS, ALLOC> &obj, JsonWriter &writer)
+        {
+            return writer.String(obj.c_str(), obj.length());
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool ObjectToJson(std::vector<TYPE, ALLOC> &obj, JsonWriter &writer)
+        {
+            return VectorToWriter(obj, writer, std::integral_constant<bool, JsonNumber<TYPE>::IS_NUMBER>());
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool VectorToWriter(std::vector<TYPE, ALLOC> &obj, JsonWriter &writer, std::false_type)
+        {
+            writer.StartArray();
+            for (size_t i = 0; i < obj.size(); i++)
+            {
+                if (!ObjectToJson(obj[i], writer))
+                    return false;
+            }
+            return writer.EndArray();
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool VectorToWriter(std::vector<TYPE, ALLOC> &obj, JsonWriter &writer, std::true_type)
+        {
+            return NumbersToWriter(obj.data(), obj.size(), writer);
+        }
+
+        template <typename TYPE>
+        static bool ObjectToJson(JsonMatrix<TYPE> &obj, JsonWriter &writer)
+        {
+            writer.StartArray();
+            for (size_t i = 0; i < obj.GetRowCount(); i++)
+            {
+                if (!NumbersToWriter(obj[i], obj.GetRowSize(i), writer))
+                    return false;
+            }
+            return writer.EndArray();
+        }
+
+        /**
+         * The writer only opens and closes the array; the numbers
+         * are formatted into a local buffer and copied to the
+         * output stream a chunk at a time.
+         */
+        template <typename TYPE>
+        static bool NumbersToWriter(const TYPE *data, size_t size, JsonWriter &writer)
+        {
+            writer.StartArray();
+            JsonOutputStream &stream = WriterStream::Get(writer);
+            int maxDecimalPlaces = writer.GetMaxDecimalPlaces();
+
+            char buffer[1024];
+            char *cursor = buffer;
+            for (size_t i = 0; i < size; i++)
+            {
+                // a number takes at most 25 chars
+                if (buffer + sizeof(buffer) - cursor < 32)
+                {
+                    stream.Write(buffer, cursor - buffer);
+                    cursor = buffer;
+                }
+                if (i > 0)
+                    *cursor++ = ',';
+                cursor = JsonNumber<TYPE>::Format(data[i], cursor, maxDecimalPlaces);
+                if (!cursor)
+                    return false;
+            }
+            stream.Write(buffer, cursor - buffer);
+            return writer.EndArray();
+        }
+
+        struct WriterStream : public JsonWriter
+        {
+            static JsonOutputStream &Get(JsonWriter &writer) { return *(writer.*(&WriterStream::os_)); }
+        };
+
+        template <typename TYPE, typename ALLOC>
+        static bool ObjectToJson(std::list<TYPE, ALLOC> &obj, JsonWriter &writer)
+        {
+            writer.StartArray();
+            for (auto i = obj.begin(); i != obj.end(); i++)
+            {
+                if (!ObjectToJson(*i, writer))
+                    return false;
+            }
+            return writer.EndArray();
+        }
+
+        template <typename TRAITS, typename KEYALLOC, typename TYPE, typename COMPARE, typename ALLOC>
+        static bool ObjectToJson(std::map<std::basic_string<char, TRAITS, KEYALLOC>, TYPE, COMPARE, ALLOC> &obj, JsonWriter &writer)
+        {
+            writer.StartObject();
+            for (auto iter = obj.begin(); iter != obj.end(); ++iter)
+            {
+                writer.Key(iter->first.c_str(), iter->first.length());
+                if (!ObjectToJson(iter->second, writer))
+                    return false;
+            }
+            return writer.EndObject();
+        }
+
+        static bool ObjectToJson(StringRef &obj, JsonWriter &writer)
+        {
+            return writer.String(obj.Data(), obj.Length());
+        }
+
+#if AIGC_JSON_HAS_STRING_VIEW
+        static bool ObjectToJson(std::string_view &obj, JsonWriter &writer)
+        {
+            return writer.String(obj.data(), obj.length());
+        }
+#endif
+
+        template <typename TYPE>
+        static bool ObjectToJson(Interned<TYPE> &obj, JsonWriter &writer)
+        {
+            return writer.String(obj.Get().c_str(), obj.Get().length());
+        }
+
+        static bool ObjectToJson(RawJson &obj, JsonWriter &writer)
+        {
+            if (obj.json.empty())
+                return writer.Null();
+
+            //checked like the document path does, without building a document
+            rapidjson::Reader reader;
+            rapidjson::BaseReaderHandler<> handler;
+            rapidjson::MemoryStream stream(obj.json.c_str(), obj.json.length());
+            if (reader.Parse(stream, handler).IsError())
+                return false;
+            return writer.RawValue(obj.json.c_str(), obj.json.length(), RawJsonType(obj.json));
+        }
+
+        static rapidjson::Type RawJsonType(const std::string &json)
+        {
+            size_t start = json.find_first_not_of(" \n\r\t");
+            switch (json[start])
+            {
+            case '{':
+                return rapidjson::kObjectType;
+            case '[':
+                return rapidjson::kArrayType;
+            case '"':
+                return rapidjson::kStringType;
+            case 't':
+                return rapidjson::kTrueType;
+            case 'f':
+                return rapidjson::kFalseType;
+            case 'n':
+                return rapidjson::kNullType;
+            default:
+                return rapidjson::kNumberType;
+            }
+        }
+
+        template <typename TYPE>
+        static bool ObjectToJson(Lazy<TYPE> &obj, JsonWriter &writer)
+        {
+            std::string raw = obj.GetRaw();
+            if (raw.empty())
+                return ObjectToJson(obj.Get(), writer);
+            return writer.RawValue(raw.c_str(), raw.length(), obj.GetRawType());
+        }
+
+    private:
+        /******************************************************
+         * 
+         * enable_if
+         *          
+         ******************************************************/
+        template <bool, class TYPE = void>
+        struct enable_if
+        {
+        };
+
+        template <class TYPE>
+        struct enable_if<true, TYPE>
+        {
+            typedef TYPE type;
+        };
+
+    private:
+        /******************************************************
+         * Check AIGC_JSON_HELPER
+         *      If class or struct add AIGC_JSON_HELPER,
+         *      it will go to the correct conver function.
+         * 
+         ******************************************************/
+        template <typename T>
+        struct HasConverFunction
+        {
+            template <typename TT>
+            static char func(decltype(&TT::AIGC_CONVER_JSON_TO_OBJECT));
+            template <typename TT>
+            static int func(...);
+            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
+        };
+
+        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
+        static inline bool JsonToObject(T &obj, rapidjson::Value &jsonValue)
+        {
+            if (!BaseConverJsonToObject(obj, jsonValue))
+                return false;
+            return obj.AIGC_CONVER_JSON_TO_OBJECT(jsonValue, LoadMembersNames(obj));
+        }
+
+        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
+        static inline bool JsonToObject(T &obj, rapidjson::Value &jsonValue)
+        {
+            return false;
+        }
+
+        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
+        static inline bool ObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            if (jsonValue.IsNull())
+                jsonValue.SetObject();
+            if (!BaseConverObjectToJson(obj, jsonValue, allocator))
+                return false;
+            return obj.AIGC_CONVER_OBJECT_TO_JSON(jsonValue, allocator, LoadMembersNames(obj));
+        }
+
+        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
+        static inline bool ObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            return false;
+        }
+
+        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
+        static inline bool ObjectToJson(T &obj, JsonWriter &writer)
+        {
+            writer.StartObject();
+            if (!MembersToWriter(obj, writer, std::vector<std::string>()))
+                return false;
+            return writer.EndObject();
+        }
+
+        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
+        static inline bool ObjectToJson(T &obj, JsonWriter &writer)
+        {
+            return false;
+        }
+
+        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
+        static inline bool MembersToWriter(T &obj, JsonWriter &writer, const std::vector<std::string> &skipNames)
+        {
+            return obj.AIGC_CONVER_OBJECT_TO_WRITER(writer, LoadMembersNames(obj), skipNames);
+        }
+
+        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
+        static inline bool MembersToWriter(T &obj, JsonWriter &writer, const std::vector<std::string> &skipNames)
+        {
+            return false;
+        }
+
+        template <typename T, typename enable_if<HasConverFunction<T>::has, int>::type = 0>
+        static inline bool MembersToList(T &obj, JsonMembers &members, const std::vector<std::string> &skipNames)
+        {
+            return obj.AIGC_CONVER_OBJECT_TO_MEMBERS(members, LoadMembersNames(obj), skipNames);
+        }
+
+        template <typename T, typename enable_if<!HasConverFunction<T>::has, int>::type = 0>
+        static inline bool MembersToList(T &, JsonMembers &, const std::vector<std::string> &)
+        {
+            return false;
+        }
+
+    private:
+        /******************************************************
+         * Check AIGC_JSON_HELPER_RENAME
+         *      If class or struct add AIGC_JSON_HELPER,
+         *      it will go to the correct load rename function.
+         * 
+         ******************************************************/
+        template <typename T>
+        struct HasRenameFunction
+        {
+            template <typename TT>
+            static char func(decltype(&TT::AIGC_MEMBERS_RENAME));
+            template <typename TT>
+            static int func(...);
+            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
+        };
+
+        template <typename T, typename enable_if<HasRenameFunction<T>::has, int>::type = 0>
+        static inline std::vector<std::string> LoadRenameArray(T &obj)
+        {
+            return obj.AIGC_MEMBERS_RENAME();
+        }
+
+        template <typename T, typename enable_if<!HasRenameFunction<T>::has, int>::type = 0>
+        static inline std::vector<std::string> LoadRenameArray(T &obj)
+        {
+            return std::vector<std::string>();
+        }
+
+        /**
+         * Renamed members first, the rest keep their own names.
+         * The table is built once per type and shared by all calls.
+         */
+        template <typename T>
+        static inline const std::vector<std::string> &LoadMembersNames(T &obj)
+        {
+            static const std::vector<std::string> names = MergeMembersNames(LoadRenameArray(obj), T::AIGC_MEMBERS_NAMES());
+            return names;
+        }
+
+        static std::vector<std::string> MergeMembersNames(std::vector<std::string> names, const std::vector<std::string> &standardNames)
+        {
+            for (size_t i = names.size(); i < standardNames.size(); i++)
+                names.push_back(standardNames[i]);
+            return names;
+        }
+
+    private:
+        /******************************************************
+         * Check AIGC_JSON_HELPER_BASE
+         *      If class or struct add AIGC_JSON_HELPER,
+         *      it will go to the correct base conver function.
+         * 
+         ******************************************************/
+        template <typename T>
+        struct HasBaseConverFunction
+        {
+            template <typename TT>
+            static char func(decltype(&TT::AIGC_BASE_CONVER_JSON_TO_OBJECT));
+            template <typename TT>
+            static int func(...);
+            const static bool has = (sizeof(func<T>(NULL)) == sizeof(char));
+        };
+
+        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverJsonToObject(T &obj, rapidjson::Value &jsonValue)
+        {
+            return obj.AIGC_BASE_CONVER_JSON_TO_OBJECT(jsonValue);
+        }
+
+        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverJsonToObject(T &obj, rapidjson::Value &jsonValue)
+        {
+            return true;
+        }
+
+        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            return obj.AIGC_BASE_CONVER_OBJECT_TO_JSON(jsonValue, allocator);
+        }
+
+        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToJson(T &obj, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator)
+        {
+            return true;
+        }
+
+        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToWriter(T &obj, JsonWriter &writer, const std::vector<std::string> &skipNames)
+        {
+            return obj.AIGC_BASE_CONVER_OBJECT_TO_WRITER(writer, skipNames);
+        }
+
+        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToWriter(T &, JsonWriter &, const std::vector<std::string> &)
+        {
+            return true;
+        }
+
+        template <typename T, typename enable_if<HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToMembers(T &obj, JsonMembers &members, const std::vector<std::string> &skipNames)
+        {
+            return obj.AIGC_BASE_CONVER_OBJECT_TO_MEMBERS(members, skipNames);
+        }
+
+        template <typename T, typename enable_if<!HasBaseConverFunction<T>::has, int>::type = 0>
+        static inline bool BaseConverObjectToMembers(T &, JsonMembers &, const std::vector<std::string> &)
+        {
+            return true;
+        }
+
+    private:
+        /******************************************************
+         * Common Tool Function, Contain:
+         * 1、String split
+         * 2、String Trim
+         * 3、Conver JsonValue to string
+         * 4、Conver parsed document to class\struct by keys
+         * 
+         ******************************************************/
+        static std::vector<std::string> StringSplit(const std::string &str)
+        {
+            std::vector<std::string> array;
+            std::string::size_type pos1, pos2;
+            pos1 = 0;
+            pos2 = str.find(',');
+            while (std::string::npos != pos2)
+            {
+                array.push_back(str.substr(pos1, pos2 - pos1));
+                pos1 = pos2 + 1;
+                pos2 = str.find(',', pos1);
+            }
+            if (pos1 != str.length())
+                array.push_back(str.substr(pos1));
+
+            return array;
+        }
+
+        static void StringTrim(std::vector<std::string> &array)
+        {
+            for (int i = 0; i < array.size(); i++)
+            {
+                std::string newStr = array[i];
+                if (!newStr.empty())
+                {
+                    newStr.erase(0, newStr.find_first_not_of(" "));
+                    newStr.erase(newStr.find_last_not_of(" ") + 1);
+                }
+                if (!newStr.empty())
+                {
+                    newStr.erase(0, newStr.find_first_not_of("\""));
+                    newStr.erase(newStr.find_last_not_of("\"") + 1);
+                }
+                array[i] = newStr;
+            }
+        }
+
+        static std::string GetJsonValueTypeName(rapidjson::Value &jsonValue)
+        {
+            rapidjson::Type type = jsonValue.GetType();
+            switch (type)
+            {
+            case rapidjson::Type::kArrayType:
+                return "array";
+            case rapidjson::Type::kFalseType:
+            case rapidjson::Type::kTrueType:
+                return "bool";
+            case rapidjson::Type::kObjectType:
+                return "object";
+            case rapidjson::Type::kStringType:
+                return "string";
+            case rapidjson::Type::kNumberType:
+                return "number";
+            default:
+                return "string";
+            }
+        }
+
+        /**
+         * Buffer being decoded by JsonToObjectInsitu on this thread,
+         * the only text StringRef and string_view may point into.
+         */
+        struct InsituRange
+        {
+            const char *begin;
+            const char *end;
+        };
+
+        static InsituRange &CurrentInsituRange()
+        {
+            static thread_local InsituRange range = {NULL, NULL};
+            return range;
+        }
+
+        static bool InInsituBuffer(const char *str, size_t length)
+        {
+            InsituRange &range = CurrentInsituRange();
+            return range.begin && str >= range.begin && str + length <= range.end;
+        }
+
+        struct InsituScope
+        {
+            InsituScope(const char *begin, const char *end) : saved(CurrentInsituRange())
+            {
+                CurrentInsituRange().begin = begin;
+                CurrentInsituRange().end = end;
+            }
+            ~InsituScope() { CurrentInsituRange() = saved; }
+
+            InsituRange saved;
+        };
+
+        /**
+         * Text of the document being decoded on this thread, for
+         * RawJson to keep its source bytes. Not set for streams.
+         */
+        static JsonSourceMap *&CurrentSource()
+        {
+            static thread_local JsonSourceMap *source = NULL;
+            return source;
+        }
+
+        static const JsonValueFrame *&CurrentFrame()
+        {
+            static thread_local const JsonValueFrame *frame = NULL;
+            return frame;
+        }
+
+        // Marks a member or element as being decoded
+        struct ValueFrame
+        {
+            explicit ValueFrame(const rapidjson::Value &value)
+            {
+                frame.value = &value;
+                frame.parent = CurrentFrame();
+                CurrentFrame() = &frame;
+            }
+            ~ValueFrame() { CurrentFrame() = frame.parent; }
+
+            JsonValueFrame frame;
+        };
+
+        struct SourceScope
+        {
+            SourceScope(const char *data, size_t length, const rapidjson::Value &root)
+                : map(data, length, root), saved(CurrentSource()), savedFrame(CurrentFrame())
+            {
+                CurrentSource() = &map;
+                CurrentFrame() = NULL;
+            }
+            ~SourceScope()
+            {
+                CurrentSource() = saved;
+                CurrentFrame() = savedFrame;
+            }
+
+            JsonSourceMap map;
+            JsonSourceMap *saved;
+            const JsonValueFrame *savedFrame;
+        };
+
+        /**
+         * Object being recycled on this thread, and a default
+         * constructed one of its type to reset missing members from.
+         * Elements of recycled vectors and lists are targets of
+         * their own while they are decoded.
+         */
+        struct RecycleTarget
+        {
+            const char *object;
+            const char *prototype;
+            size_t size;
+        };
+
+        static const RecycleTarget *&CurrentRecycle()
+        {
+            static thread_local const RecycleTarget *target = NULL;
+            return target;
+        }
+
+        static bool RecycleMode() { return CurrentRecycle() != NULL; }
+
+        template <typename T>
+        struct RecycleScope
+        {
+            explicit RecycleScope(T &obj) : saved(CurrentRecycle())
+            {
+                target.object = reinterpret_cast<const char *>(&obj);
+                target.prototype = reinterpret_cast<const char *>(Prototype<T>(std::is_default_constructible<T>()));
+                target.size = sizeof(T);
+                CurrentRecycle() = &target;
+            }
+            ~RecycleScope() { CurrentRecycle() = saved; }
+
+            RecycleTarget target;
+            const RecycleTarget *saved;
+        };
+
+        // Built on the first recycled decode of a T
+        template <typename T>
+        static const T *Prototype(std::true_type)
+        {
+            static const T prototype{};
+            return &prototype;
+        }
+
+        template <typename T>
+        static const T *Prototype(std::false_type)
+        {
+            return NULL;
+        }
+
+        template <typename T, typename DOCUMENT>
+        static bool DocumentToObject(T &obj, DOCUMENT &root, const std::vector<std::string> &keys, const char *data, size_t length)
+        {
+            SourceScope scope(data, length, root);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        template <typename T, typename DOCUMENT>
+        static bool DocumentToObject(T &obj, DOCUMENT &root, const std::vector<std::string> &keys)
+        {
+            if (root.HasParseError() || root.IsNull())
+                return false;
+
+            rapidjson::Value *value = &root;
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                const char *find = keys[i].c_str();
+                if (!value->IsObject() || !value->HasMember(find))
+                    return false;
+                value = &(*value)[find];
+            }
+            ValueFrame frame(*value);
+            return JsonToObject(obj, *value);
+        }
+
+        /**
+         * Reads a top-level array of numbers into a vector, without 
+         * building a document first
+         */
+        template <typename TYPE, typename ALLOC>
+        struct NumberArrayHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, NumberArrayHandler<TYPE, ALLOC>>
+        {
+            explicit NumberArrayHandler(std::vector<TYPE, ALLOC> &values) : values(values), depth(0) {}
+
+            bool Int(int i) { return Add(rapidjson::Value(i)); }
+            bool Uint(unsigned u) { return Add(rapidjson::Value(u)); }
+            bool Int64(int64_t i) { return Add(rapidjson::Value(i)); }
+            bool Uint64(uint64_t u) { return Add(rapidjson::Value(u)); }
+            bool Double(double d) { return Add(rapidjson::Value(d)); }
+            bool EndArray(rapidjson::SizeType) { return --depth == 0; }
+
+            bool StartArray()
+            {
+                if (depth > 0)
+                    return Default();
+                depth++;
+                return true;
+            }
+
+            bool Add(const rapidjson::Value &value)
+            {
+                if (depth != 1 || !JsonNumber<TYPE>::Is(value))
+                    return Default();
+                values.push_back(JsonNumber<TYPE>::Get(value));
+                return true;
+            }
+
+            bool Default()
+            {
+                // the failed element is kept, as the document path does
+                if (depth == 1)
+                    values.emplace_back();
+                return false;
+            }
+
+            std::vector<TYPE, ALLOC> &values;
+            int depth;
+        };
+
+        template <typename TYPE, typename ALLOC>
+        static bool StringToNumbers(std::vector<TYPE, ALLOC> &obj, const std::string &jsonStr, std::true_type)
+        {
+            // json text of a number array has one comma less than numbers
+            std::vector<TYPE, ALLOC> values(obj.get_allocator());
+            values.reserve(std::count(jsonStr.begin(), jsonStr.end(), ',') + 1);
+
+            NumberArrayHandler<TYPE, ALLOC> handler(values);
+            rapidjson::Reader reader;
+            rapidjson::StringStream stream(jsonStr.c_str());
+            rapidjson::ParseResult result = reader.Parse(stream, handler);
+            if (result.IsError() && result.Code() != rapidjson::kParseErrorTermination)
+                return false;
+
+            obj.swap(values);
+            return !result.IsError();
+        }
+
+        template <typename TYPE, typename ALLOC>
+        static bool StringToNumbers(std::vector<TYPE, ALLOC> &, const std::string &, std::false_type)
+        {
+            return false;
+        }
+
+    public:
+        static std::string StringFromJsonValue(rapidjson::Value &jsonValue)
+        {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+            jsonValue.Accept(writer);
+            std::string ret = std::string(buffer.GetString());
+            return ret;
+        }
+
+    public:
+        /******************************************************
+         * External interface: 
+         * 
+         * a、Conver json string to class\struct:
+         *      1) T GetObjectByJson(string, bool*)
+         *      2) T GetObjectByJson(string, vector<string>, bool*)
+         *      3) bool JsonToObject(string, vector<string>)
+         *      4) bool JsonToObject(FILE* | istream | JsonInputStream, vector<string>)
+         *      5) bool JsonFileToObject(path, [JsonFileOptions], vector<string>)
+         *      6) bool JsonValueToObject(rapidjson::Value, [char*, size_t])
+         *      7) bool JsonToObjects(vector<T>, vector<string>, [JsonParallelOptions], vector<string>)
+         *      8) bool JsonToObjectInsitu(char*, vector<string>)
+         *      9) bool JsonToObject(char*, size_t, JsonParseContext, vector<string>)
+         *      10) bool JsonToRecycledObject(string, vector<string>)
+         *      11) bool JsonValueToRecycledObject(rapidjson::Value, [char*, size_t])
+         * 
+         * b、Conver class\struct to json string:
+         *      1) string GetJsonByObject(T, bool*)
+         *      2) bool ObjectToJson(string, T)
+         *      3) bool ObjectToJson(FILE* | ostream | JsonOutputStream, T)
+         *      4) bool ObjectToJsonWriter(JsonWriter, T)
+         *      5) bool ObjectsToJson(vector<T>, vector<string>, [JsonParallelOptions])
+         *      6) bool ObjectToMembers(T, JsonMembers)
+         * 
+         * c、Get last error message: GetLastErrMessage
+         * 
+         ******************************************************/
+        template <typename T>
+        static T GetObjectByJson(const std::string &jsonStr, bool *isSuccess = NULL)
+        {
+            T obj;
+            bool check = JsonToObject(obj, jsonStr, {});
+            if (isSuccess)
+                *isSuccess = check;
+            return obj;
+        }
+
+        template <typename T>
+        static T GetObjectByJson(const std::string &jsonStr, std::vector<std::string> keys, bool *isSuccess = NULL)
+        {
+            T obj;
+            bool check = JsonToObject(obj, jsonStr, keys);
+            if (isSuccess)
+                *isSuccess = check;
+            return obj;
+        }
+
+        /**
+         * @brief conver json string to class | struct
+         * @param obj : class or struct or base-types
+         * @param jsonStr : json string 
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonToObject(T &obj, const std::string &jsonStr, std::vector<std::string> keys = {})
+        {
+            rapidjson::Document root;
+            root.Parse(jsonStr.c_str());
+            return DocumentToObject(obj, root, keys, jsonStr.c_str(), jsonStr.length());
+        }
+
+        /**
+         * @brief conver json string to vector, a top-level array of
+         *        int\uint、int64_t\uint64_t、float or double is read
+         *        straight into the vector without a document
+         * @param obj : vector
+         * @param jsonStr : json string 
+         * @param keys : obj-item keys
+         */
+        template <typename TYPE, typename ALLOC>
+        static inline bool JsonToObject(std::vector<TYPE, ALLOC> &obj, const std::string &jsonStr, std::vector<std::string> keys = {})
+        {
+            if (JsonNumber<TYPE>::IS_NUMBER && keys.empty())
+                return StringToNumbers(obj, jsonStr, std::integral_constant<bool, JsonNumber<TYPE>::IS_NUMBER>());
+
+            rapidjson::Document root;
+            root.Parse(jsonStr.c_str());
+            return DocumentToObject(obj, root, keys, jsonStr.c_str(), jsonStr.length());
+        }
+
+        /**
+         * @brief conver json read from a file to class | struct, 
+         *        the file is read through a fixed-size buffer
+         * @param obj : class or struct or base-types
+         * @param fp : file opened for read
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonToObject(T &obj, FILE *fp, std::vector<std::string> keys = {})
+        {
+            if (!fp)
+                return false;
+
+            std::vector<char> buffer(READ_BUFFER_SIZE);
+            rapidjson::FileReadStream stream(fp, &buffer[0], buffer.size());
+            rapidjson::Document root;
+            root.ParseStream(stream);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        template <typename T>
+        static inline bool JsonToObject(T &obj, std::istream &is, std::vector<std::string> keys = {})
+        {
+            std::vector<char> buffer(READ_BUFFER_SIZE);
+            rapidjson::IStreamWrapper stream(is, &buffer[0], buffer.size());
+            rapidjson::Document root;
+            root.ParseStream(stream);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        /**
+         * @brief conver json file to class | struct
+         * @param obj : class or struct or base-types
+         * @param path : json file path
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonFileToObject(T &obj, const std::string &path, std::vector<std::string> keys = {})
+        {
+            return JsonFileToObject(obj, path, JsonFileOptions(), keys);
+        }
+
+        /**
+         * @brief conver json file to class | struct
+         * @param obj : class or struct or base-types
+         * @param path : json file path
+         * @param options : mmap, in-situ parsing and read buffer settings
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonFileToObject(T &obj, const std::string &path, const JsonFileOptions &options, std::vector<std::string> keys = {})
+        {
+            FILE *fp = NULL;
+#if AIGC_JSON_HAS_MMAP
+            if (options.useMmap)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    return false;
+
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+                {
+                    size_t size = st.st_size;
+                    // In-situ parsing needs a '\0' after the text, which the
+                    // zero-filled tail of the last page provides
+                    bool insitu = options.insitu && size % ::sysconf(_SC_PAGESIZE) != 0;
+                    int prot = insitu ? PROT_READ | PROT_WRITE : PROT_READ;
+                    void *data = ::mmap(NULL, size, prot, MAP_PRIVATE, fd, 0);
+                    ::close(fd);
+                    if (data == MAP_FAILED)
+                        return false;
+                    ::madvise(data, size, MADV_SEQUENTIAL);
+
+                    rapidjson::Document root;
+                    if (insitu)
+                        root.ParseInsitu(static_cast<char *>(data));
+                    else
+                        root.Parse(static_cast<const char *>(data), size);
+                    bool check = insitu ? DocumentToObject(obj, root, keys) : DocumentToObject(obj, root, keys, static_cast<const char *>(data), size);
+                    ::munmap(data, size);
+                    return check;
+                }
+
+                // Pipes can not be reopened, keep reading from this fd
+                fp = ::fdopen(fd, "rb");
+                if (!fp)
+                {
+                    ::close(fd);
+                    return false;
+                }
+            }
+#endif
+            if (!fp)
+                fp = std::fopen(path.c_str(), "rb");
+            if (!fp)
+                return false;
+
+            std::vector<char> buffer(options.bufferSize > 4 ? options.bufferSize : 4);
+            rapidjson::FileReadStream stream(fp, &buffer[0], buffer.size());
+            rapidjson::Document root;
+            root.ParseStream(stream);
+            std::fclose(fp);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        template <typename T>
+        static inline bool JsonToObject(T &obj, JsonInputStream &stream, std::vector<std::string> keys = {})
+        {
+            rapidjson::Document root;
+            root.ParseStream(stream);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        /**
+         * @brief conver parsed json value to class | struct
+         * @param obj : class or struct or base-types
+         * @param jsonValue : json value, eg. a document kept by JsonParseContext
+         */
+        template <typename T>
+        static inline bool JsonValueToObject(T &obj, rapidjson::Value &jsonValue)
+        {
+            SourceScope scope(NULL, 0, jsonValue);
+            return JsonToObject(obj, jsonValue);
+        }
+
+        /**
+         * @brief conver json value to class | struct
+         * @param obj : class or struct or base-types
+         * @param jsonValue : json value parsed from data, with default flags
+         * @param data : the json text, for RawJson members to keep it as it is
+         * @param length : json length
+         */
+        template <typename T>
+        static inline bool JsonValueToObject(T &obj, rapidjson::Value &jsonValue, const char *data, size_t length)
+        {
+            SourceScope scope(data, length, jsonValue);
+            return JsonToObject(obj, jsonValue);
+        }
+
+        /**
+         * @brief conver json string to class | struct reused from an
+         *        earlier decode, members missing from the json are reset
+         *        to their value in a default constructed T, built once per
+         *        type, so the result is the same as decoding into a new
+         *        object while strings and containers keep their memory,
+         *        and vector and list elements are decoded in place
+         * @param obj : class or struct or base-types
+         * @param jsonStr : json string
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonToRecycledObject(T &obj, const std::string &jsonStr, std::vector<std::string> keys = {})
+        {
+            RecycleScope<T> scope(obj);
+            return JsonToObject(obj, jsonStr, keys);
+        }
+
+        /**
+         * @brief conver parsed json value to class | struct reused from
+         *        an earlier decode, see JsonToRecycledObject
+         * @param obj : class or struct or base-types
+         * @param jsonValue : json value parsed from data, with default flags
+         * @param data : the json text, for RawJson members to keep it as it is,
+         *               NULL when it is not at hand
+         * @param length : json length
+         */
+        template <typename T>
+        static inline bool JsonValueToRecycledObject(T &obj, rapidjson::Value &jsonValue, const char *data = NULL, size_t length = 0)
+        {
+            RecycleScope<T> scope(obj);
+            return JsonValueToObject(obj, jsonValue, data, length);
+        }
+
+        /**
+         * @brief conver json to class | struct through a parse context,
+         *        eg. one set up on a stack buffer so small documents
+         *        parse without heap allocation
+         * @param obj : class or struct or base-types
+         * @param data : json text, need not be null-terminated
+         * @param length : json length
+         * @param context : parse context, the document is kept until the next parse
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonToObject(T &obj, const char *data, size_t length, JsonParseContext &context, std::vector<std::string> keys = {})
+        {
+            JsonDocument &root = context.Parse(data, length);
+            if (context.HasParseError())
+                return false;
+            return DocumentToObject(obj, root, keys, data, length);
+        }
+
+        /**
+         * @brief conver json to class | struct parsing the buffer in place,
+         *        StringRef and string_view members point into the buffer
+         *        and are valid as long as it is
+         * @param obj : class or struct or base-types
+         * @param buffer : null-terminated json, overwritten while parsing
+         * @param keys : obj-item keys
+         */
+        template <typename T>
+        static inline bool JsonToObjectInsitu(T &obj, char *buffer, std::vector<std::string> keys = {})
+        {
+            if (!buffer)
+                return false;
+
+            InsituScope scope(buffer, buffer + std::strlen(buffer));
+            rapidjson::Document root;
+            root.ParseInsitu(buffer);
+            return DocumentToObject(obj, root, keys);
+        }
+
+        /**
+         * @brief conver a batch of json strings to class | struct, one object
+         *        per string, the parse context is set up once for the batch
+         * @param objs : resized to the number of json strings
+         * @param jsonStrs : json strings, eg. messages taken from a queue
+         * @param keys : obj-item keys
+         * @return false if any string fails, the others are still converted
+         */
+        template <typename T>
+        static inline bool JsonToObjects(std::vector<T> &objs, const std::vector<std::string> &jsonStrs, std::vector<std::string> keys = {})
+        {
+            objs.resize(jsonStrs.size());
+            return StringsToObjects(objs, jsonStrs, 0, jsonStrs.size(), keys);
+        }
+
+        /**
+         * @brief conver a batch of json strings to class | struct,
+         *        large batches are split between threads
+         * @param options : threads to use, chunkSize and the rest are not used
+         */
+        template <typename T>
+        static inline bool JsonToObjects(std::vector<T> &objs, const std::vector<std::string> &jsonStrs, const JsonParallelOptions &options, std::vector<std::string> keys = {})
+        {
+            objs.resize(jsonStrs.size());
+            return RunBatch(jsonStrs.size(), options, [&](size_t begin, size_t end) {
+                return StringsToObjects(objs, jsonStrs, begin, end, keys);
+            });
+        }
+
+        /**
+         * @brief conver class | struct to json through a writer,
+         *        eg. to reuse one writer for many objects
+         * @param obj : class or struct or base-types
+         * @param writer : json writer
+         */
+        template <typename T>
+        static inline bool ObjectToJsonWriter(T &obj, JsonWriter &writer)
+        {
+            return ObjectToJson(obj, writer);
+        }
+
+        /**
+         * @brief list the registered members of class | struct,
+         *        base-class members first, as the writer orders them
+         * @param obj : class or struct
+         * @param members : member list
+         */
+        template <typename T>
+        static inline bool ObjectToMembers(T &obj, JsonMembers &members)
+        {
+            return MembersToList(obj, members, std::vector<std::string>());
+        }
+
+        // True for class | struct with AIGC_JSON_HELPER, which ObjectToMembers can list
+        template <typename T>
+        struct IsRegistered
+        {
+            const static bool value = HasConverFunction<T>::has;
+        };
+
+        template <typename T>
+        static std::string GetJsonByObject(T &obj, bool *isSuccess)
+        {
+            std::string ret = "";
+            bool check = ObjectToJson(obj, ret);
+            if (isSuccess)
+                *isSuccess = check;
+            return ret;
+        }
+
+        /**
+         * @brief conver class | struct to json string
+         * @param obj : class or struct
+         * @param jsonStr : json string 
+         */
+        template <typename T>
+        static inline bool ObjectToJson(T &obj, std::string &jsonStr)
+        {
+            std::string ret;
+            JsonStringOutputStream stream(ret);
+            if (!ObjectToJson(obj, stream))
+                return false;
+
+            jsonStr.swap(ret);
+            return true;
+        }
+
+        /**
+         * @brief conver class | struct to json and write it to a stream,
+         *        without building a json document in memory
+         * @param obj : class or struct
+         * @param stream : output stream, flushed before return
+         */
+        template <typename T>
+        static inline bool ObjectToJson(T &obj, JsonOutputStream &stream)
+        {
+            JsonWriter writer(stream);
+            bool check = ObjectToJson(obj, writer);
+            stream.Flush();
+            return check && stream.Good();
+        }
+
+        template <typename T>
+        static inline bool ObjectToJson(T &obj, FILE *fp)
+        {
+            JsonFileOutputStream stream(fp);
+            return ObjectToJson(obj, stream);
+        }
+
+        template <typename T>
+        static inline bool ObjectToJson(T &obj, std::ostream &os)
+        {
+            JsonOStreamOutputStream stream(os);
+            return ObjectToJson(obj, stream);
+        }
+
+        /**
+         * @brief conver a batch of class | struct to json strings, one writer
+         *        is reused for the whole batch
+         * @param objs : class or struct or base-types
+         * @param jsonStrs : resized to the number of objects, a string is
+         *                   left empty when its object fails
+         * @return false if any object fails, the others are still converted
+         */
+        template <typename T>
+        static inline bool ObjectsToJson(std::vector<T> &objs, std::vector<std::string> &jsonStrs)
+        {
+            jsonStrs.resize(objs.size());
+            return ObjectsToStrings(objs, jsonStrs, 0, objs.size());
+        }
+
+        template <typename T>
+        static inline bool ObjectsToJson(std::vector<T> &objs, std::vector<std::string> &jsonStrs, const JsonParallelOptions &options)
+        {
+            jsonStrs.resize(objs.size());
+            return RunBatch(objs.size(), options, [&](size_t begin, size_t end) {
+                return ObjectsToStrings(objs, jsonStrs, begin, end);
+            });
+        }
+
+    private:
+        // Items of a batch given to a thread at a time
+        static const size_t BATCH_RANGE_ITEMS = 256;
+
+        template <typename T>
+        static bool StringsToObjects(std::vector<T> &objs, const std::vector<std::string> &jsonStrs, size_t begin, size_t end, const std::vector<std::string> &keys)
+        {
+            JsonParseContext context;
+            bool check = true;
+            for (size_t i = begin; i < end; i++)
+            {
+                JsonDocument &root = context.Parse(jsonStrs[i].c_str(), jsonStrs[i].size());
+                if (!DocumentToObject(objs[i], root, keys, jsonStrs[i].c_str(), jsonStrs[i].size()))
+                    check = false;
+            }
+            return check;
+        }
+
+        template <typename T>
+        static bool ObjectsToStrings(std::vector<T> &objs, std::vector<std::string> &jsonStrs, size_t begin, size_t end)
+        {
+            bool check = true;
+            JsonWriter writer;
+            for (size_t i = begin; i < end; i++)
+            {
+                std::string &jsonStr = jsonStrs[i];
+                jsonStr.clear();
+                JsonStringOutputStream stream(jsonStr);
+                writer.Reset(stream);
+                if (ObjectToJson(objs[i], writer))
+                {
+                    stream.Flush();
+                    continue;
+                }
+                check = false;
+                stream.Flush();
+                jsonStr.clear();
+            }
+            return check;
+        }
+
+        /**
+         * Splits [0, count) into ranges of BATCH_RANGE_ITEMS, handed
+         * out to the calling thread and the executor's helpers.
+         */
+        template <typename FUNC>
+        static bool RunBatch(size_t count, const JsonParallelOptions &options, FUNC func)
+        {
+            std::atomic<bool> check(true);
+            size_t ranges = (count + BATCH_RANGE_ITEMS - 1) / BATCH_RANGE_ITEMS;
+            JsonParallel::For(options, ranges, [&](size_t i) {
+                size_t begin = i * BATCH_RANGE_ITEMS;
+                if (!func(begin, std::min(begin + BATCH_RANGE_ITEMS, count)))
+                    check = false;
+            });
+            return check;
+        }
+
+    public:
+        /******************************************************
+         * Cycle conversion:
+         *      1) write class\struct members from json value
+         *      2) read class\struct members to json value
+         *      3) write class\struct base-class
+         *      4) read class\struct base-class
+         * 
+         ******************************************************/
+        static std::vector<std::string> GetMembersNames(const std::string membersStr)
+        {
+            std::vector<std::string> array = StringSplit(membersStr);
+            StringTrim(array);
+            return array;
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool WriteMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, TYPE &arg, TYPES &... args)
+        {
+            if (!WriteMembers(names, index, jsonValue, arg))
+                return false;
+            return WriteMembers(names, ++index, jsonValue, args...);
+        }
+
+        template <typename TYPE>
+        static bool WriteMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, TYPE &arg)
+        {
+            const char *key = names[index].c_str();
+            if (jsonValue.IsNull())
+                return ResetMember(arg);
+            if (!jsonValue.IsObject())
+                return false;
+            if (!jsonValue.HasMember(key))
+                return ResetMember(arg);
+
+            rapidjson::Value &member = jsonValue[key];
+            ValueFrame frame(member);
+            bool check = JsonToObject(arg, member);
+
+            PrintJsonToObject(member, names[index], check);
+            return check;
+        }
+
+        /**
+         * Members missing from the json keep their value, unless
+         * the object is being recycled, see JsonToRecycledObject.
+         * They are then copied from the same offset of the
+         * prototype of the recycled object, so default member
+         * initializers and constructors of the decoded type, not
+         * of the class registering the member, apply. Members
+         * that cannot be assigned, that live outside the object,
+         * eg. static ones, or of a type that cannot be default
+         * constructed are left as they are.
+         */
+        template <typename TYPE, typename enable_if<std::is_copy_assignable<TYPE>::value, int>::type = 0>
+        static bool ResetMember(TYPE &arg)
+        {
+            const RecycleTarget *target = CurrentRecycle();
+            if (!target || !target->prototype)
+                return true;
+
+            uintptr_t begin = reinterpret_cast<uintptr_t>(target->object);
+            uintptr_t member = reinterpret_cast<uintptr_t>(&arg);
+            if (member < begin || member + sizeof(TYPE) > begin + target->size)
+                return true;
+
+            arg = *reinterpret_cast<const TYPE *>(target->prototype + (member - begin));
+            return true;
+        }
+
+        template <typename TYPE, typename enable_if<!std::is_copy_assignable<TYPE>::value, int>::type = 0>
+        static bool ResetMember(TYPE &)
+        {
+            return true;
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE &arg, TYPES &... args)
+        {
+            if (!ReadMembers(names, index, jsonValue, allocator, arg))
+                return false;
+            return ReadMembers(names, ++index, jsonValue, allocator, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE &arg)
+        {
+            rapidjson::Value item;
+            bool check = ObjectToJson(arg, item, allocator);
+
+            PrintObjectToJson(names[index], check);
+            if (!check)
+                return false;
+
+            if (jsonValue.HasMember(names[index].c_str()))
+            {
+                jsonValue.RemoveMember(names[index].c_str());
+            }
+
+            rapidjson::Value key;
+            key.SetString(names[index].c_str(), names[index].length(), allocator);
+            jsonValue.AddMember(key, item, allocator);
+            return true;
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, JsonWriter &writer, const std::vector<std::string> &skipNames, TYPE &arg, TYPES &... args)
+        {
+            if (!ReadMembers(names, index, writer, skipNames, arg))
+                return false;
+            return ReadMembers(names, ++index, writer, skipNames, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, JsonWriter &writer, const std::vector<std::string> &skipNames, TYPE &arg)
+        {
+            for (size_t i = 0; i < skipNames.size(); i++)
+            {
+                if (skipNames[i] == names[index])
+                    return true;
+            }
+
+            writer.Key(names[index].c_str(), names[index].length());
+            bool check = ObjectToJson(arg, writer);
+
+            PrintObjectToJson(names[index], check);
+            return check;
+        }
+
+        /**
+         * Base-class members go first, except the ones the class
+         * registers again itself, so every key is written once.
+         */
+        template <typename T>
+        static bool ReadBaseMembers(T &obj, JsonWriter &writer, const std::vector<std::string> &names, const std::vector<std::string> &skipNames)
+        {
+            if (!HasBaseConverFunction<T>::has)
+                return true;
+
+            std::vector<std::string> baseSkipNames = skipNames;
+            baseSkipNames.insert(baseSkipNames.end(), names.begin(), names.end());
+            return BaseConverObjectToWriter(obj, writer, baseSkipNames);
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, JsonMembers &members, const std::vector<std::string> &skipNames, TYPE &arg, TYPES &... args)
+        {
+            if (!ReadMembers(names, index, members, skipNames, arg))
+                return false;
+            return ReadMembers(names, ++index, members, skipNames, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadMembers(const std::vector<std::string> &names, int index, JsonMembers &members, const std::vector<std::string> &skipNames, TYPE &arg)
+        {
+            for (size_t i = 0; i < skipNames.size(); i++)
+            {
+                if (skipNames[i] == names[index])
+                    return true;
+            }
+
+            JsonMember member = {&names[index], &arg, &JsonStepValue<TYPE>::Push};
+            members.push_back(member);
+            return true;
+        }
+
+        template <typename T>
+        static bool ReadBaseMembers(T &obj, JsonMembers &members, const std::vector<std::string> &names, const std::vector<std::string> &skipNames)
+        {
+            if (!HasBaseConverFunction<T>::has)
+                return true;
+
+            std::vector<std::string> baseSkipNames = skipNames;
+            baseSkipNames.insert(baseSkipNames.end(), names.begin(), names.end());
+            return BaseConverObjectToMembers(obj, members, baseSkipNames);
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool WriteBase(rapidjson::Value &jsonValue, TYPE *arg, TYPES *... args)
+        {
+            if (!WriteBase(jsonValue, arg))
+                return false;
+            return WriteBase(jsonValue, args...);
+        }
+
+        template <typename TYPE>
+        static bool WriteBase(rapidjson::Value &jsonValue, TYPE *arg)
+        {
+            if (jsonValue.IsNull())
+                return false;
+            return aigc::JsonHelper::JsonToObject(*arg, jsonValue);
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadBase(rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE *arg, TYPES *... args)
+        {
+            if (!ReadBase(jsonValue, allocator, arg))
+                return false;
+            return ReadBase(jsonValue, allocator, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadBase(rapidjson::Value &jsonValue, rapidjson::Document::AllocatorType &allocator, TYPE *arg)
+        {
+            return aigc::JsonHelper::ObjectToJson(*arg, jsonValue, allocator);
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadBase(JsonWriter &writer, const std::vector<std::string> &skipNames, TYPE *arg, TYPES *... args)
+        {
+            if (!ReadBase(writer, skipNames, arg))
+                return false;
+            return ReadBase(writer, skipNames, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadBase(JsonWriter &writer, const std::vector<std::string> &skipNames, TYPE *arg)
+        {
+            return aigc::JsonHelper::MembersToWriter(*arg, writer, skipNames);
+        }
+
+        template <typename TYPE, typename... TYPES>
+        static bool ReadBase(JsonMembers &members, const std::vector<std::string> &skipNames, TYPE *arg, TYPES *... args)
+        {
+            if (!ReadBase(members, skipNames, arg))
+                return false;
+            return ReadBase(members, skipNames, args...);
+        }
+
+        template <typename TYPE>
+        static bool ReadBase(JsonMembers &members, const std::vector<std::string> &skipNames, TYPE *arg)
+        {
+            return aigc::JsonHelper::MembersToList(*arg, members, skipNames);
+        }
+
+    private:
+        /******************************************************
+         * 
+         * Print debug-message:
+         * 
+         ******************************************************/
+        static void PrintJsonToObject(rapidjson::Value &jsonValue, const std::string &name, bool success)
+        {
+#ifdef JSONHELPER_DEBUG
+            std::string jsonType = GetJsonValueTypeName(jsonValue);
+            std::string flag = success ? "[SUCCESS] " : "[ERROR] ";
+            std::string value = "jsonValue-" + jsonType + " --> " + name;
+            std::cout << flag + value << std::endl;
+#endif // DEBUG
+        }
+
+        static void PrintObjectToJson(const std::string &name, bool success)
+        {
+#ifdef JSONHELPER_DEBUG
+            std::string flag = success ? "[SUCCESS] " : "[ERROR] ";
+            std::string value = name + " --> jsonValue";
+            std::cout << flag + value << std::endl;
+#endif // DEBUG
+        }
+    };
+
+    /******************************************************
+     * Process-wide table of distinct strings, split into
+     * shards with their own lock so decoding threads seldom
+     * wait on each other. Entries live until the process
+     * exits, so it suits values from a small set.
+     ******************************************************/
+    template <typename T>
+    class JsonInternTable
+    {
+    public:
+        /**
+         * @brief the one stored copy of the text, added on first use
+         * @param data : text, need not be null-terminated
+         * @param length : text length
+         */
+        static const T *Intern(const char *data, size_t length)
+        {
+            //default-constructed Interned values are empty, they skip the shard lock
+            if (length == 0)
+            {
+                static const T *empty = Insert(data, length);
+                return empty;
+            }
+            return Insert(data, length);
+        }
+
+        static size_t GetSize()
+        {
+            size_t size = 0;
+            for (size_t i = 0; i < SHARDS; i++)
+            {
+                Shard &shard = GetShard(i);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                size += shard.values.size();
+            }
+            return size;
+        }
+
+    private:
+        static const size_t SHARDS = 16;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            // Keys point at the stored copies
+            std::unordered_map<JsonStringKey, const T *, JsonStringKey::Hash, JsonStringKey::Equal> keys;
+            // Deque growth keeps the stored values in place
+            std::deque<T> values;
+        };
+
+        static const T *Insert(const char *data, size_t length)
+        {
+            JsonStringKey key = JsonStringKey::Make(data, length);
+            Shard &shard = GetShard(key.hash);
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto iter = shard.keys.find(key);
+            if (iter != shard.keys.end())
+                return iter->second;
+
+            shard.values.emplace_back(data, length);
+            key.data = shard.values.back().data();
+            shard.keys.insert(std::make_pair(key, &shard.values.back()));
+            return &shard.values.back();
+        }
+
+        static Shard &GetShard(size_t hash)
+        {
+            static Shard shards[SHARDS];
+            return shards[hash % SHARDS];
+        }
+    };
+
+    /******************************************************
+     * String member stored once per distinct value
+     *      Holds a pointer into JsonInternTable, records
+     *      with the same value share one copy, and equality
+     *      is a pointer compare.
+     * eg:
+     * struct Test
+     * {
+     *      aigc::Interned<std::string> Status;
+     *      AIGC_JSON_HELPER(Status)
+     * };
+     *      if (test.Status == aigc::Interned<std::string>("done"))
+     ******************************************************/
+    template <typename T>
+    class Interned
+    {
+    public:
+        Interned() : value_(JsonInternTable<T>::Intern("", 0)) {}
+        Interned(const T &value) : value_(JsonInternTable<T>::Intern(value.data(), value.length())) {}
+        Interned(const char *value) : value_(JsonInternTable<T>::Intern(value, std::strlen(value))) {}
+        Interned(const char *data, size_t length) : value_(JsonInternTable<T>::Intern(data, length)) {}
+
+        const T &Get() const { return *value_; }
+        operator const T &() const { return *value_; }
+        const T *operator->() const { return value_; }
+
+        bool operator==(const Interned &other) const { return value_ == other.value_; }
+        bool operator!=(const Interned &other) const { return value_ != other.value_; }
+        bool operator<(const Interned &other) const { return *value_ < *other.value_; }
+
+    private:
+        const T *value_;
+    };
+
+    /******************************************************
+     * Member decoded on first access
+     *      Decoding only copies the json text of the member,
+     *      the source bytes where RawJson would keep them,
+     *      Get() decodes it once (thread-safe) and caches the
+     *      result. Left untouched, the text is written back
+     *      as it is. A null member loads as a default T.
+     *      A type mismatch inside the member is reported by
+     *      Load() on first access, not by the outer decode.
+     * eg:
+     * struct Test
+     * {
+     *      string A;
+     *      aigc::Lazy<Detail> B;
+     *      AIGC_JSON_HELPER(A, B)
+     * };
+     *      test.B->Name;
+     ******************************************************/
+    template <typename T>
+    class Lazy
+    {
+    public:
+        Lazy() : rawType_(rapidjson::kNullType), loaded_(true), check_(true) {}
+
+        Lazy(const T &value) : value_(value), rawType_(rapidjson::kNullType), loaded_(true), check_(true) {}
+
+        Lazy(const Lazy &other) : rawType_(rapidjson::kNullType), loaded_(true), check_(true)
+        {
+            *this = other;
+        }
+
+        Lazy &operator=(const Lazy &other)
+        {
+            if (this == &other)
+                return *this;
+
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            value_ = other.value_;
+            raw_ = other.raw_;
+            rawType_ = other.rawType_;
+            check_ = other.check_;
+            loaded_.store(other.loaded_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        Lazy &operator=(const T &value)
+        {
+            value_ = value;
+            std::string().swap(raw_);
+            check_ = true;
+            loaded_.store(true, std::memory_order_release);
+            return *this;
+        }
+
+        /**
+         * @brief decode the member if not done yet
+         * @return false if the json did not match T
+         */
+        bool Load()
+        {
+            if (!loaded_.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!loaded_.load(std::memory_order_relaxed))
+                {
+                    if (rawType_ != rapidjson::kNullType)
+                        check_ = JsonHelper::JsonToObject(value_, raw_);
+                    std::string().swap(raw_);
+                    loaded_.store(true, std::memory_order_release);
+                }
+            }
+            return check_;
+        }
+
+        T &Get()
+        {
+            Load();
+            return value_;
+        }
+
+        T &operator*() { return Get(); }
+        T *operator->() { return &Get(); }
+
+        bool IsLoaded() const { return loaded_.load(std::memory_order_acquire); }
+
+        // Json text still waiting to be decoded, empty once loaded
+        bool IsPending() const { return !IsLoaded(); }
+        std::string GetRaw() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return raw_;
+        }
+        rapidjson::Type GetRawType() const { return rawType_; }
+
+        void SetRaw(std::string raw, rapidjson::Type type)
+        {
+            value_ = T();
+            raw_.swap(raw);
+            rawType_ = type;
+            check_ = true;
+            loaded_.store(false, std::memory_order_release);
+        }
+
+    private:
+        T value_;
+        std::string raw_;
+        rapidjson::Type rawType_;
+        std::atomic<bool> loaded_;
+        bool check_;
+        mutable std::mutex mutex_;
+    };
+
+    /******************************************************
+     * Resumable encoder doing a bounded amount of work per
+     * call. The member graph is walked with an explicit
+     * frame stack instead of recursion, so Step() can stop
+     * after a byte or time budget and carry on later exactly
+     * where it left off. Output matches ObjectToJson.
+     * A string or number is never split, so one step can go
+     * past the byte budget by a single value.
+     * eg:
+     *      std::string out;
+     *      aigc::JsonStringOutputStream stream(out);
+     *      aigc::JsonStepEncoder encoder(test, stream);
+     *      while (!encoder.IsDone())
+     *      {
+     *          if (!encoder.Step(16 * 1024))
+     *              break;
+     *          send(out);
+     *          out.clear();
+     *      }
+     ******************************************************/
+    class JsonStepEncoder
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        /**
+         * @param obj : class or struct or base-types, must outlive the encoder
+         * @param stream : output stream, flushed at the end of every step
+         */
+        template <typename T>
+        JsonStepEncoder(T &obj, JsonOutputStream &stream)
+            : stream_(stream), writer_(stream), error_(false)
+        {
+            JsonMember root = {NULL, &obj, &JsonStepValue<T>::Push};
+            frames_.push_back(std::unique_ptr<Frame>(new RootFrame(root)));
+        }
+
+        /**
+         * @brief encode until about maxBytes more bytes are written
+         * @return false on error
+         */
+        bool Step(size_t maxBytes)
+        {
+            return Run(maxBytes, false, Clock::time_point());
+        }
+
+        /**
+         * @brief encode until the time budget is used up,
+         *        or about maxBytes more bytes are written
+         * @return false on error
+         */
+        template <typename REP, typename PERIOD>
+        bool Step(std::chrono::duration<REP, PERIOD> budget, size_t maxBytes = size_t(-1))
+        {
+            return Run(maxBytes, true, Clock::now() + std::chrono::duration_cast<Clock::duration>(budget));
+        }
+
+        bool IsDone() const { return frames_.empty() && !error_; }
+
+        bool HasError() const { return error_; }
+
+        // Number of bytes written so far
+        size_t GetSize() const { return stream_.Tell(); }
+
+    private:
+        template <typename TYPE>
+        friend struct JsonStepValue;
+
+        // Clock reads are spread out, one per this many frame steps
+        static const size_t CLOCK_CHECK_STEPS = 64;
+
+        struct Frame
+        {
+            virtual ~Frame() {}
+            // Write a little or push a child frame, a frame
+            // with a child on top of it is never done
+            virtual bool Step(JsonStepEncoder &encoder, bool &done) = 0;
+        };
+
+        struct RootFrame : Frame
+        {
+            explicit RootFrame(const JsonMember &root) : root(root), pushed(false) {}
+
+            virtual bool Step(JsonStepEncoder &encoder, bool &done)
+            {
+                if (pushed)
+                {
+                    done = true;
+                    return true;
+                }
+                pushed = true;
+                bool check = root.push(encoder, root.value);
+                done = encoder.frames_.back().get() == this;
+                return check;
+            }
+
+            JsonMember root;
+            bool pushed;
+        };
+
+        struct ObjectFrame : Frame
+        {
+            ObjectFrame() : index(0), started(false) {}
+
+            virtual bool Step(JsonStepEncoder &encoder, bool &done)
+            {
+                if (!started)
+                {
+                    started = true;
+                    return encoder.writer_.StartObject();
+                }
+                if (index == members.size())
+                {
+                    done = true;
+                    return encoder.writer_.EndObject();
+                }
+                JsonMember &member = members[index++];
+                encoder.writer_.Key(member.name->c_str(), member.name->length());
+                return member.push(encoder, member.value);
+            }
+
+            JsonMembers members;
+            size_t index;
+            bool started;
+        };
+
+        template <typename CONTAINER>
+        struct ArrayFrame : Frame
+        {
+            explicit ArrayFrame(CONTAINER &obj) : obj(obj), iter(obj.begin()), started(false) {}
+
+            virtual bool Step(JsonStepEncoder &encoder, bool &done)
+            {
+                if (!started)
+                {
+                    started = true;
+                    return encoder.writer_.StartArray();
+                }
+                if (iter == obj.end())
+                {
+                    done = true;
+                    return encoder.writer_.EndArray();
+                }
+                return encoder.Push(*iter++);
+            }
+
+            CONTAINER &obj;
+            typename CONTAINER::iterator iter;
+            bool started;
+        };
+
+        template <typename MAP>
+        struct MapFrame : Frame
+        {
+            explicit MapFrame(MAP &obj) : obj(obj), iter(obj.begin()), started(false) {}
+
+            virtual bool Step(JsonStepEncoder &encoder, bool &done)
+            {
+                if (!started)
+                {
+                    started = true;
+                    return encoder.writer_.StartObject();
+                }
+                if (iter == obj.end())
+                {
+                    done = true;
+                    return encoder.writer_.EndObject();
+                }
+                encoder.writer_.Key(iter->first.c_str(), iter->first.length());
+                return encoder.Push((iter++)->second);
+            }
+
+            MAP &obj;
+            typename MAP::iterator iter;
+            bool started;
+        };
+
+        /**
+         * Registered classes get a frame over their member list,
+         * base-types are written at once.
+         */
+        template <typename T>
+        bool Push(T &obj)
+        {
+            return PushObject(obj, std::integral_constant<bool, JsonHelper::IsRegistered<T>::value>());
+        }
+
+        template <typename T>
+        bool PushObject(T &obj, std::true_type)
+        {
+            std::unique_ptr<ObjectFrame> frame(new ObjectFrame());
+            if (!JsonHelper::ObjectToMembers(obj, frame->members))
+                return JsonHelper::ObjectToJsonWriter(obj, writer_);
+            frames_.push_back(std::move(frame));
+            return true;
+        }
+
+        template <typename T>
+        bool PushObject(T &obj, std::false_type)
+        {
+            return JsonHelper::ObjectToJsonWriter(obj, writer_);
+        }
+
+        template <typename TYPE, typename ALLOC>
+        bool Push(std::vector<TYPE, ALLOC> &obj)
+        {
+            frames_.push_back(std::unique_ptr<Frame>(new ArrayFrame<std::vector<TYPE, ALLOC>>(obj)));
+            return true;
+        }
+
+        template <typename TYPE, typename ALLOC>
+        bool Push(std::list<TYPE, ALLOC> &obj)
+        {
+            frames_.push_back(std::unique_ptr<Frame>(new ArrayFrame<std::list<TYPE, ALLOC>>(obj)));
+            return true;
+        }
+
+        template <typename TRAITS, typename KEYALLOC, typename TYPE, typename COMPARE, typename ALLOC>
+        bool Push(std::map<std::basic_string<char, TRAITS, KEYALLOC>, TYPE, COMPARE, ALLOC> &obj)
+        {
+            typedef std::map<std::basic_string<char, TRAITS, KEYALLOC>, TYPE, COMPARE, ALLOC> MAP;
+            frames_.push_back(std::unique_ptr<Frame>(new MapFrame<MAP>(obj)));
+            return true;
+        }
+
+        bool Run(size_t maxBytes, bool timed, Clock::time_point deadline)
+        {
+            if (error_)
+                return false;
+
+            // Every call makes progress, even with a zero budget
+            size_t start = stream_.Tell();
+            size_t steps = 0;
+            while (!frames_.empty())
+            {
+                Frame *frame = frames_.back().get();
+                bool done = false;
+                if (!frame->Step(*this, done))
+                {
+                    error_ = true;
+                    break;
+                }
+                if (done)
+                    frames_.pop_back();
+
+                if (stream_.Tell() - start >= maxBytes)
+                    break;
+                if (timed && ++steps % CLOCK_CHECK_STEPS == 0 && Clock::now() >= deadline)
+                    break;
+            }
+
+            stream_.Flush();
+            if (!stream_.Good())
+                error_ = true;
+            return !error_;
+        }
+
+        JsonStepEncoder(const JsonStepEncoder &);
+        JsonStepEncoder &operator=(const JsonStepEncoder &);
+
+        JsonOutputStream &stream_;
+        JsonWriter writer_;
+        std::vector<std::unique_ptr<Frame>> frames_;
+        bool error_;
+    };
+
+    template <typename TYPE>
+    struct JsonStepValue
+    {
+        static bool Push(JsonStepEncoder &encoder, void *value)
+        {
+            return encoder.Push(*static_cast<TYPE *>(value));
+        }
+    };
+
+    /******************************************************
+     * Per-thread pool of decoded objects
+     *      Handles give their object back to the pool of the
+     *      thread releasing them, objects are decoded with
+     *      JsonToRecycledObject, so once warmed up no T is
+     *      constructed or destroyed, apart from the prototype
+     *      missing members are reset from. Vector and list elements
+     *      are reused as well, only arrays growing beyond
+     *      their last size construct new ones; map entries
+     *      are rebuilt on every decode.
+     * eg:
+     *      bool check;
+     *      auto test = aigc::JsonObjectPool<Test>::GetObjectByJson(jsonStr, &check);
+     *      test->A;
+     ******************************************************/
+    template <typename T>
+    class JsonObjectPool
+    {
+    public:
+        class Handle
+        {
+        public:
+            Handle() {}
+            explicit Handle(std::unique_ptr<T> obj) : obj_(std::move(obj)) {}
+            Handle(Handle &&other) : obj_(std::move(other.obj_)) {}
+
+            Handle &operator=(Handle &&other)
+            {
+                Reset();
+                obj_ = std::move(other.obj_);
+                return *this;
+            }
+
+            ~Handle() { Reset(); }
+
+            // Give the object back to the pool now
+            void Reset()
+            {
+                if (obj_)
+                    Release(std::move(obj_));
+            }
+
+            T *Get() const { return obj_.get(); }
+            T &operator*() const { return *obj_; }
+            T *operator->() const { return obj_.get(); }
+            explicit operator bool() const { return obj_ != nullptr; }
+
+        private:
+            Handle(const Handle &);
+            Handle &operator=(const Handle &);
+
+            std::unique_ptr<T> obj_;
+        };
+
+        /**
+         * @brief take an object from the pool, or a new one if it is empty,
+         *        a pooled object keeps the values of its last use
+         */
+        static Handle Acquire()
+        {
+            std::vector<std::unique_ptr<T>> &objects = Objects();
+            if (objects.empty())
+                return Handle(std::unique_ptr<T>(new T()));
+
+            Handle handle(std::move(objects.back()));
+            objects.pop_back();
+            return handle;
+        }
+
+        /**
+         * @brief take an object from the pool and conver json string to it
+         * @param jsonStr : json string
+         * @param isSuccess : set to the conversion result
+         * @param keys : obj-item keys
+         */
+        static Handle GetObjectByJson(const std::string &jsonStr, bool *isSuccess = NULL, std::vector<std::string> keys = {})
+        {
+            Handle handle = Acquire();
+            bool check = JsonHelper::JsonToRecycledObject(*handle, jsonStr, keys);
+            if (isSuccess)
+                *isSuccess = check;
+            return handle;
+        }
+
+        // Objects kept by the calling thread's pool beyond this are destroyed
+        static void SetCapacity(size_t capacity)
+        {
+            Capacity() = capacity;
+            std::vector<std::unique_ptr<T>> &objects = Objects();
+            if (objects.size() > capacity)
+                objects.resize(capacity);
+        }
+
+        static size_t GetPooledCount() { return Objects().size(); }
+
+    private:
+        static const size_t DEFAULT_CAPACITY = 64;
+
+        static std::vector<std::unique_ptr<T>> &Objects()
+        {
+            static thread_local std::vector<std::unique_ptr<T>> objects;
+            return objects;
+        }
+
+        static size_t &Capacity()
+        {
+            static thread_local size_t capacity = DEFAULT_CAPACITY;
+            return capacity;
+        }
+
+        static void Release(std::unique_ptr<T> obj)
+        {
+            std::vector<std::unique_ptr<T>> &objects = Objects();
+            if (objects.size() < Capacity())
+                objects.push_back(std::move(obj));
+        }
+    };
+
+    /******************************************************
+     * Read newline-delimited json (json lines), one record
+     * per line. Memory used depends on the longest line,
+     * not on the size of the input.
+     * eg:
+     *      aigc::JsonFileInputStream stream(fp);
+     *      aigc::JsonLinesReader<Test> reader(stream);
+     *      Test test;
+     *      while (reader.Next(test))
+     *          ...
+     *      if (reader.HasError())
+     *          reader.GetErrorMessage();
+     ******************************************************/
+    template <typename T>
+    class JsonLinesReader
+    {
+    public:
+        explicit JsonLinesReader(JsonInputStream &stream)
+            : stream_(stream), lineNumber_(0), hasError_(false) {}
+
+        /**
+         * @brief decode the next record, blank lines are skipped
+         * @param obj : decoded in place, members missing from the
+         *              line keep their previous value
+         * @return false at the end of input or on error
+         */
+        bool Next(T &obj)
+        {
+            return Read(obj, false);
+        }
+
+        /**
+         * @brief decode every record into one reused object, members
+         *        missing from a line are reset as JsonToRecycledObject does
+         * @param func : called as func(T &) for each record
+         */
+        template <typename FUNC>
+        bool ForEach(FUNC func)
+        {
+            T obj;
+            while (Read(obj, true))
+                func(obj);
+            return !hasError_;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Line of the last record read, or of the error
+        size_t GetLineNumber() const { return lineNumber_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        bool Read(T &obj, bool recycle)
+        {
+            const char *data;
+            size_t length;
+            while (!hasError_ && ReadLine(data, length))
+            {
+                lineNumber_++;
+                if (IsBlank(data, length))
+                    continue;
+
+                JsonDocument &root = context_.Parse(data, length);
+                if (context_.HasParseError())
+                    return SetError(context_.GetErrorMessage());
+                bool check = recycle ? JsonHelper::JsonValueToRecycledObject(obj, root, data, length)
+                                     : JsonHelper::JsonValueToObject(obj, root, data, length);
+                if (!check)
+                    return SetError("conver json to object failed");
+                return true;
+            }
+            return false;
+        }
+
+        bool ReadLine(const char *&data, size_t &length)
+        {
+            line_.clear();
+            while (stream_.Fill())
+            {
+                const char *begin = stream_.Current();
+                size_t available = stream_.Available();
+                const char *end = static_cast<const char *>(std::memchr(begin, '\n', available));
+                if (!end)
+                {
+                    line_.append(begin, available);
+                    stream_.Skip(available);
+                    continue;
+                }
+
+                size_t size = end - begin;
+                stream_.Skip(size + 1);
+                if (line_.empty())
+                {
+                    data = begin;
+                    length = size;
+                    return true;
+                }
+                line_.append(begin, size);
+                break;
+            }
+
+            if (line_.empty())
+                return false;
+            data = line_.data();
+            length = line_.size();
+            return true;
+        }
+
+        static bool IsBlank(const char *data, size_t length)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                if (data[i] != ' ' && data[i] != '\t' && data[i] != '\r')
+                    return false;
+            }
+            return true;
+        }
+
+        bool SetError(const std::string &message)
+        {
+            char line[32];
+            std::snprintf(line, sizeof(line), "line %u: ", (unsigned)lineNumber_);
+            errorMessage_ = line + message;
+            hasError_ = true;
+            return false;
+        }
+
+        JsonInputStream &stream_;
+        JsonParseContext context_;
+        std::string line_;
+        size_t lineNumber_;
+        bool hasError_;
+        std::string errorMessage_;
+    };
+
+    /******************************************************
+     * Read a large top-level json array element by element.
+     * Memory used depends on the largest element, not on
+     * the size of the array.
+     * eg:
+     *      aigc::JsonFileInputStream stream(fp);
+     *      aigc::JsonArrayReader<Test> reader(stream);
+     *      Test test;
+     *      while (reader.Next(test))
+     *          ...
+     ******************************************************/
+    template <typename T>
+    class JsonArrayReader
+    {
+    public:
+        explicit JsonArrayReader(JsonInputStream &stream)
+            : stream_(stream), index_(0), started_(false), done_(false), hasError_(false)
+        {
+            reader_.IterativeParseInit();
+        }
+
+        /**
+         * @brief decode the next element
+         * @param obj : decoded in place, members missing from the
+         *              element keep their previous value
+         * @return false at the end of the array or on error
+         */
+        bool Next(T &obj)
+        {
+            return Read(obj, false);
+        }
+
+        /**
+         * @brief decode every element into one reused object, members
+         *        missing from an element are reset as JsonToRecycledObject does
+         * @param func : called as func(T &) for each element
+         */
+        template <typename FUNC>
+        bool ForEach(FUNC func)
+        {
+            T obj;
+            while (Read(obj, true))
+                func(obj);
+            return !hasError_;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Number of elements read so far, or index of the failed one
+        size_t GetIndex() const { return index_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        static const unsigned PARSE_FLAGS = rapidjson::kParseIterativeFlag;
+
+        bool Read(T &obj, bool recycle)
+        {
+            if (done_ || hasError_)
+                return false;
+            if (!started_ && !Start())
+                return false;
+
+            context_.Reset();
+            JsonDocument &root = context_.GetDocument();
+            ElementGenerator generator(*this);
+            root.Populate(generator);
+            if (done_ || hasError_)
+                return false;
+
+            bool check = recycle ? JsonHelper::JsonValueToRecycledObject(obj, root) : JsonHelper::JsonValueToObject(obj, root);
+            if (!check)
+                return SetError("conver json to object failed");
+            index_++;
+            return true;
+        }
+
+        struct ArrayStartHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ArrayStartHandler>
+        {
+            bool Default() { return false; }
+            bool StartArray() { return true; }
+        };
+
+        /**
+         * Forwards the events of one element to the document and
+         * tracks nesting, the end of the top-level array is kept back.
+         */
+        struct ElementHandler
+        {
+            JsonDocument &document;
+            int depth;
+            bool endOfArray;
+
+            explicit ElementHandler(JsonDocument &doc) : document(doc), depth(0), endOfArray(false) {}
+
+            bool Null() { return document.Null(); }
+            bool Bool(bool b) { return document.Bool(b); }
+            bool Int(int i) { return document.Int(i); }
+            bool Uint(unsigned i) { return document.Uint(i); }
+            bool Int64(int64_t i) { return document.Int64(i); }
+            bool Uint64(uint64_t i) { return document.Uint64(i); }
+            bool Double(double d) { return document.Double(d); }
+            bool RawNumber(const char *str, rapidjson::SizeType length, bool copy) { return document.RawNumber(str, length, copy); }
+            bool String(const char *str, rapidjson::SizeType length, bool copy) { return document.String(str, length, copy); }
+            bool Key(const char *str, rapidjson::SizeType length, bool copy) { return document.Key(str, length, copy); }
+
+            bool StartObject()
+            {
+                depth++;
+                return document.StartObject();
+            }
+
+            bool EndObject(rapidjson::SizeType memberCount)
+            {
+                depth--;
+                return document.EndObject(memberCount);
+            }
+
+            bool StartArray()
+            {
+                depth++;
+                return document.StartArray();
+            }
+
+            bool EndArray(rapidjson::SizeType elementCount)
+            {
+                if (depth == 0)
+                {
+                    endOfArray = true;
+                    return true;
+                }
+                depth--;
+                return document.EndArray(elementCount);
+            }
+        };
+
+        struct ElementGenerator
+        {
+            JsonArrayReader &owner;
+
+            explicit ElementGenerator(JsonArrayReader &reader) : owner(reader) {}
+
+            bool operator()(JsonDocument &document)
+            {
+                ElementHandler handler(document);
+                do
+                {
+                    if (!owner.reader_.template IterativeParseNext<PARSE_FLAGS>(owner.stream_, handler))
+                        return owner.SetParseError();
+                    if (handler.endOfArray)
+                    {
+                        owner.done_ = true;
+                        return false;
+                    }
+                } while (handler.depth > 0);
+                return true;
+            }
+        };
+
+        bool Start()
+        {
+            started_ = true;
+            ArrayStartHandler handler;
+            if (!reader_.template IterativeParseNext<PARSE_FLAGS>(stream_, handler))
+            {
+                if (reader_.GetParseErrorCode() == rapidjson::kParseErrorTermination)
+                    return SetError("json is not an array");
+                return SetParseError();
+            }
+            return true;
+        }
+
+        bool SetParseError()
+        {
+            char offset[32];
+            std::snprintf(offset, sizeof(offset), " (offset %u)", (unsigned)reader_.GetErrorOffset());
+            return SetError(std::string(rapidjson::GetParseError_En(reader_.GetParseErrorCode())) + offset);
+        }
+
+        bool SetError(const std::string &message)
+        {
+            char index[32];
+            std::snprintf(index, sizeof(index), "element %u: ", (unsigned)index_);
+            errorMessage_ = index + message;
+            hasError_ = true;
+            return false;
+        }
+
+        JsonInputStream &stream_;
+        rapidjson::Reader reader_;
+        JsonParseContext context_;
+        size_t index_;
+        bool started_;
+        bool done_;
+        bool hasError_;
+        std::string errorMessage_;
+    };
+
+    /******************************************************
+     * Read json values written back to back into one stream,
+     * eg. {..}{..}{..}, or as a json text sequence (RFC 7464)
+     * where every value starts with the RS character (0x1E).
+     * Each value is parsed straight from the stream and the
+     * parse stops at its end, the rest is neither copied nor
+     * scanned again.
+     * eg:
+     *      aigc::JsonFdInputStream stream(fd);
+     *      aigc::JsonSequenceReader<Test> reader(stream);
+     *      Test test;
+     *      while (reader.Next(test))
+     *          ...
+     ******************************************************/
+    template <typename T>
+    class JsonSequenceReader
+    {
+    public:
+        explicit JsonSequenceReader(JsonInputStream &stream)
+            : stream_(stream), index_(0), hasError_(false) {}
+
+        /**
+         * @brief decode the next value
+         * @param obj : decoded in place, members missing from the
+         *              value keep their previous value
+         * @return false at the end of the stream or on error
+         */
+        bool Next(T &obj)
+        {
+            return Read(obj, false);
+        }
+
+        /**
+         * @brief decode every value into one reused object, members
+         *        missing from a value are reset as JsonToRecycledObject does
+         * @param func : called as func(T &) for each value
+         */
+        template <typename FUNC>
+        bool ForEach(FUNC func)
+        {
+            T obj;
+            while (Read(obj, true))
+                func(obj);
+            return !hasError_;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Number of values read so far, or index of the failed one
+        size_t GetIndex() const { return index_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        static const unsigned PARSE_FLAGS = rapidjson::kParseStopWhenDoneFlag;
+        static const char RECORD_SEPARATOR = 0x1E;
+
+        bool Read(T &obj, bool recycle)
+        {
+            if (hasError_ || !SkipSeparators())
+                return false;
+
+            JsonDocument &root = context_.ParseStream<PARSE_FLAGS>(stream_);
+            if (context_.HasParseError())
+                return SetError(context_.GetErrorMessage());
+            bool check = recycle ? JsonHelper::JsonValueToRecycledObject(obj, root) : JsonHelper::JsonValueToObject(obj, root);
+            if (!check)
+                return SetError("conver json to object failed");
+            index_++;
+            return true;
+        }
+
+        // Returns false when only separators are left
+        bool SkipSeparators()
+        {
+            while (stream_.Fill())
+            {
+                const char *current = stream_.Current();
+                size_t available = stream_.Available();
+                size_t i = 0;
+                while (i < available && IsSeparator(current[i]))
+                    i++;
+                stream_.Skip(i);
+                if (i < available)
+                    return true;
+            }
+            return false;
+        }
+
+        static bool IsSeparator(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == RECORD_SEPARATOR;
+        }
+
+        bool SetError(const std::string &message)
+        {
+            char index[32];
+            std::snprintf(index, sizeof(index), "value %u: ", (unsigned)index_);
+            errorMessage_ = index + message;
+            hasError_ = true;
+            return false;
+        }
+
+        JsonInputStream &stream_;
+        JsonParseContext context_;
+        size_t index_;
+        bool hasError_;
+        std::string errorMessage_;
+    };
+
+    /******************************************************
+     * Decode json pushed in chunks of any size, eg. as it
+     * arrives from a socket. The parser state is kept between
+     * chunks, so a document is parsed while it arrives and
+     * only the bytes of a token cut by a chunk boundary are
+     * kept back. Several documents may follow each other.
+     * eg:
+     *      aigc::JsonPushDecoder<Test> decoder;
+     *      while ((size = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+     *      {
+     *          decoder.Feed(buffer, size);
+     *          while (decoder.Next(test))
+     *              ...
+     *      }
+     *      decoder.Finish();
+     ******************************************************/
+    template <typename T>
+    class JsonPushDecoder
+    {
+    public:
+        JsonPushDecoder()
+            : position_(0), scanned_(0), offset_(0), started_(false), finished_(false), index_(0), hasError_(false) {}
+
+        /**
+         * @brief parse a chunk of json
+         * @return false on error
+         */
+        bool Feed(const char *data, size_t size)
+        {
+            if (hasError_)
+                return false;
+            if (finished_)
+                return SetError("data fed after finish");
+
+            // Only the token cut by the last chunk is left
+            buffer_.erase(0, position_);
+            offset_ += position_;
+            scanned_ = scanned_ > position_ ? scanned_ - position_ : 0;
+            position_ = 0;
+            buffer_.append(data, size);
+            return Parse();
+        }
+
+        /**
+         * @brief end of the input
+         * @return false on error, eg. when a document is not complete
+         */
+        bool Finish()
+        {
+            if (hasError_)
+                return false;
+            finished_ = true;
+            if (!Parse())
+                return false;
+            if (!started_)
+                return true;
+
+            // Let the parser tell what is missing
+            rapidjson::MemoryStream stream(buffer_.data() + position_, buffer_.size() - position_);
+            reader_.IterativeParseNext<PARSE_FLAGS>(stream, context_.GetDocument());
+            return SetParseError(position_);
+        }
+
+        /**
+         * @brief take the next decoded document
+         * @return false when no document is complete yet
+         */
+        bool Next(T &obj)
+        {
+            if (objects_.empty())
+                return false;
+            obj = std::move(objects_.front());
+            objects_.pop_front();
+            return true;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Number of documents decoded so far, or index of the failed one
+        size_t GetIndex() const { return index_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        static const unsigned PARSE_FLAGS = rapidjson::kParseStopWhenDoneFlag;
+
+        struct RootGenerator
+        {
+            bool operator()(JsonDocument &) { return true; }
+        };
+
+        bool Parse()
+        {
+            while (true)
+            {
+                if (!started_)
+                {
+                    position_ = SkipWhitespace(position_);
+                    if (position_ == buffer_.size())
+                        return true;
+                    context_.Reset();
+                    reader_.IterativeParseInit();
+                    started_ = true;
+                }
+                if (!HasToken())
+                    return true;
+
+                // The document takes the parser events as they come
+                rapidjson::MemoryStream stream(buffer_.data() + position_, buffer_.size() - position_);
+                JsonDocument &root = context_.GetDocument();
+                bool check = reader_.IterativeParseNext<PARSE_FLAGS>(stream, root);
+                size_t base = position_;
+                position_ += stream.Tell();
+                scanned_ = 0;
+                if (!check)
+                    return SetParseError(base);
+                if (!reader_.IterativeParseComplete())
+                    continue;
+
+                // Move the finished root from the stack into the document
+                RootGenerator generator;
+                root.Populate(generator);
+                started_ = false;
+                objects_.push_back(T());
+                if (!JsonHelper::JsonValueToObject(objects_.back(), root))
+                {
+                    objects_.pop_back();
+                    return SetError("conver json to object failed");
+                }
+                index_++;
+            }
+        }
+
+        /**
+         * Whether the buffer holds all the next parser step reads:
+         * a delimiter if any, then a whole token. Numbers and
+         * literals end at the next character that can not be part
+         * of them, which has to be there too unless finished.
+         */
+        bool HasToken()
+        {
+            const char *data = buffer_.data();
+            size_t size = buffer_.size();
+            size_t i = SkipWhitespace(position_);
+            if (i < size && (data[i] == ',' || data[i] == ':'))
+                i = SkipWhitespace(i + 1);
+            if (i == size)
+                return false;
+
+            char c = data[i];
+            if (c == '{' || c == '}' || c == '[' || c == ']')
+                return true;
+
+            // Carry on where the last chunk left the token
+            size_t j = std::max(i + 1, scanned_);
+            if (c == '"')
+            {
+                for (; j < size; j++)
+                {
+                    if (data[j] == '\\')
+                    {
+                        if (j + 1 == size)
+                            break;
+                        j++;
+                    }
+                    else if (data[j] == '"')
+                        return true;
+                }
+            }
+            else
+            {
+                for (; j < size; j++)
+                {
+                    if (IsTokenEnd(data[j]))
+                        return true;
+                }
+            }
+            scanned_ = j;
+            return finished_;
+        }
+
+        size_t SkipWhitespace(size_t i) const
+        {
+            while (i < buffer_.size() && IsWhitespace(buffer_[i]))
+                i++;
+            return i;
+        }
+
+        static bool IsWhitespace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        static bool IsTokenEnd(char c)
+        {
+            return IsWhitespace(c) || c == ',' || c == ':' || c == '[' || c == ']' || c == '{' || c == '}' || c == '"';
+        }
+
+        bool SetParseError(size_t base)
+        {
+            char offset[32];
+            std::snprintf(offset, sizeof(offset), " (offset %u)", (unsigned)(offset_ + base + reader_.GetErrorOffset()));
+            return SetError(std::string(rapidjson::GetParseError_En(reader_.GetParseErrorCode())) + offset);
+        }
+
+        bool SetError(const std::string &message)
+        {
+            char index[32];
+            std::snprintf(index, sizeof(index), "document %u: ", (unsigned)index_);
+            errorMessage_ = index + message;
+            hasError_ = true;
+            return false;
+        }
+
+        std::string buffer_;
+        size_t position_;
+        size_t scanned_;
+        size_t offset_;
+        rapidjson::Reader reader_;
+        JsonParseContext context_;
+        std::deque<T> objects_;
+        bool started_;
+        bool finished_;
+        size_t index_;
+        bool hasError_;
+        std::string errorMessage_;
+    };
+
+#if AIGC_JSON_HAS_COROUTINES
+    /******************************************************
+     * Lazy coroutine task of the async apis, started when it
+     * is awaited and resuming its awaiter when done. Event
+     * loops can also Start() a task and check IsDone().
+     ******************************************************/
+    template <typename T>
+    class JsonTask
+    {
+    public:
+        struct promise_type
+        {
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::coroutine_handle<> continuation;
+
+            JsonTask get_return_object() { return JsonTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void return_value(T result) { value = std::move(result); }
+
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        JsonTask(JsonTask &&other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+
+        JsonTask &operator=(JsonTask &&other) noexcept
+        {
+            std::swap(handle_, other.handle_);
+            return *this;
+        }
+
+        ~JsonTask()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool await_ready() const { return handle_.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter)
+        {
+            handle_.promise().continuation = awaiter;
+            return handle_;
+        }
+
+        T await_resume() { return Get(); }
+
+        // Run the task until it first suspends
+        void Start()
+        {
+            if (handle_ && !handle_.done())
+                handle_.resume();
+        }
+
+        // False for a task moved from
+        bool IsDone() const { return handle_ && handle_.done(); }
+
+        // Result of a finished task, throws std::logic_error if it is not done or was taken already
+        T Get()
+        {
+            if (!IsDone())
+                throw std::logic_error("JsonTask is not done");
+            if (handle_.promise().error)
+                std::rethrow_exception(handle_.promise().error);
+            if (!handle_.promise().value)
+                throw std::logic_error("JsonTask result was taken already");
+            T result = std::move(*handle_.promise().value);
+            handle_.promise().value.reset();
+            return result;
+        }
+
+    private:
+        explicit JsonTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        JsonTask(const JsonTask &) = delete;
+        JsonTask &operator=(const JsonTask &) = delete;
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    /******************************************************
+     * Decode json read from an async byte source, yielding
+     * to the event loop at every chunk. The source is any
+     * object with
+     *      awaitable<size_t> Read(char *buffer, size_t size)
+     * returning 0 at the end.
+     * eg:
+     *      aigc::JsonAsyncReader<Test, Socket> reader(socket);
+     *      Test test;
+     *      while (co_await reader.Next(test))
+     *          ...
+     ******************************************************/
+    template <typename T, typename SOURCE>
+    class JsonAsyncReader
+    {
+    public:
+        explicit JsonAsyncReader(SOURCE &source, size_t bufferSize = 64 * 1024)
+            : source_(source), buffer_(bufferSize > 0 ? bufferSize : 1), finished_(false) {}
+
+        /**
+         * @brief decode the next document
+         * @return false at the end of the source or on error
+         */
+        JsonTask<bool> Next(T &obj)
+        {
+            while (!decoder_.Next(obj))
+            {
+                if (finished_ || decoder_.HasError())
+                    co_return false;
+
+                size_t size = co_await source_.Read(&buffer_[0], buffer_.size());
+                if (size == 0)
+                {
+                    finished_ = true;
+                    decoder_.Finish();
+                }
+                else
+                    decoder_.Feed(&buffer_[0], size);
+            }
+            co_return true;
+        }
+
+        bool HasError() const { return decoder_.HasError(); }
+
+        std::string GetErrorMessage() const { return decoder_.GetErrorMessage(); }
+
+    private:
+        SOURCE &source_;
+        std::vector<char> buffer_;
+        JsonPushDecoder<T> decoder_;
+        bool finished_;
+    };
+
+    /******************************************************
+     * Async conversions of the coroutine apis. The sink is
+     * any object with
+     *      awaitable<bool> Write(const char *data, size_t size)
+     ******************************************************/
+    class JsonAsync
+    {
+    public:
+        /**
+         * @brief conver json read from an async source to class | struct
+         * @param source : async byte source, see JsonAsyncReader
+         */
+        template <typename T, typename SOURCE>
+        static JsonTask<bool> JsonToObject(T &obj, SOURCE &source)
+        {
+            JsonAsyncReader<T, SOURCE> reader(source);
+            co_return co_await reader.Next(obj);
+        }
+
+        /**
+         * @brief write class | struct as json to an async sink, about
+         *        chunkSize is encoded with JsonStepEncoder between writes,
+         *        so the whole output is never held at once
+         */
+        template <typename T, typename SINK>
+        static JsonTask<bool> ObjectToJson(T &obj, SINK &sink, size_t chunkSize = 64 * 1024)
+        {
+            std::string buffer;
+            JsonStringOutputStream stream(buffer);
+            JsonStepEncoder encoder(obj, stream);
+            while (!encoder.IsDone())
+            {
+                if (!encoder.Step(chunkSize))
+                    co_return false;
+                if (!buffer.empty() && !co_await sink.Write(buffer.data(), buffer.size()))
+                    co_return false;
+                buffer.clear();
+            }
+            co_return true;
+        }
+
+        /**
+         * @brief write a vector as a json array to an async sink,
+         *        elements are encoded between writes, so no more
+         *        than about chunkSize is held at a time
+         */
+        template <typename T, typename SINK>
+        static JsonTask<bool> ArrayToJson(std::vector<T> &obj, SINK &sink, size_t chunkSize = 64 * 1024)
+        {
+            std::string buffer = "[";
+            JsonWriter writer;
+            for (size_t i = 0; i < obj.size(); i++)
+            {
+                if (i > 0)
+                    buffer += ',';
+                {
+                    JsonStringOutputStream stream(buffer);
+                    writer.Reset(stream);
+                    if (!JsonHelper::ObjectToJsonWriter(obj[i], writer))
+                        co_return false;
+                    stream.Flush();
+                }
+                if (buffer.size() >= chunkSize)
+                {
+                    if (!co_await sink.Write(buffer.data(), buffer.size()))
+                        co_return false;
+                    buffer.clear();
+                }
+            }
+            buffer += ']';
+            co_return co_await sink.Write(buffer.data(), buffer.size());
+        }
+    };
+#endif // AIGC_JSON_HAS_COROUTINES
+
+    /******************************************************
+     * A block of whole json lines and what decoding it gave:
+     * the records, the number of lines and the first error.
+     ******************************************************/
+    template <typename T>
+    struct JsonLinesBlock
+    {
+        std::vector<T> records;
+        size_t lineCount;
+        size_t errorLine;
+        std::string error;
+
+        JsonLinesBlock() : lineCount(0), errorLine(0) {}
+
+        /**
+         * Decode the lines, records are kept in the block
+         * when func is NULL, or passed to func one by one in
+         * a reused object whose missing members are reset.
+         */
+        template <typename FUNC>
+        void Decode(const char *data, size_t size, JsonParseContext &context, FUNC *func)
+        {
+            records.clear();
+            errorLine = 0;
+            error.clear();
+
+            T local;
+            const char *current = data;
+            const char *end = data + size;
+            size_t line = 0;
+            while (current < end)
+            {
+                const char *found = static_cast<const char *>(std::memchr(current, '\n', end - current));
+                const char *lineEnd = found ? found : end;
+                line++;
+
+                if (!IsBlank(current, lineEnd - current))
+                {
+                    JsonDocument &root = context.Parse(current, lineEnd - current);
+                    if (context.HasParseError())
+                    {
+                        errorLine = line;
+                        error = context.GetErrorMessage();
+                        break;
+                    }
+
+                    if (!func)
+                        records.push_back(T());
+                    T &obj = func ? local : records.back();
+                    bool check = func ? JsonHelper::JsonValueToRecycledObject(obj, root, current, lineEnd - current)
+                                      : JsonHelper::JsonValueToObject(obj, root, current, lineEnd - current);
+                    if (!check)
+                    {
+                        if (!func)
+                            records.pop_back();
+                        errorLine = line;
+                        error = "conver json to object failed";
+                        break;
+                    }
+                    if (func)
+                        (*func)(obj);
+                }
+                current = found ? found + 1 : end;
+            }
+            lineCount = line;
+        }
+
+        static bool IsBlank(const char *data, size_t length)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                if (data[i] != ' ' && data[i] != '\t' && data[i] != '\r')
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    /******************************************************
+     * Decode json lines held in memory (eg. a mapped file)
+     * on several threads, each chunk with its own parse context.
+     * eg:
+     *      aigc::JsonLinesParallelReader<Test> reader(data, size);
+     *      reader.ForEach([](Test &test) { ... });
+     ******************************************************/
+    template <typename T>
+    class JsonLinesParallelReader
+    {
+    public:
+        JsonLinesParallelReader(const char *data, size_t size, const JsonParallelOptions &options = JsonParallelOptions())
+            : data_(data), size_(size), options_(options), hasError_(false), lineNumber_(0) {}
+
+        /**
+         * @brief decode every record
+         * @param func : called as func(T &) for each record. When
+         *               ordered, it runs on the calling thread in input
+         *               order, otherwise on all the decoding threads at once.
+         */
+        template <typename FUNC>
+        bool ForEach(FUNC func)
+        {
+            Split();
+            hasError_ = false;
+            errorMessage_ = "";
+            lineNumber_ = 0;
+
+            if (options_.ordered)
+                DecodeOrdered(func);
+            else
+                DecodeUnordered(func);
+            return !hasError_;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Line of the error
+        size_t GetLineNumber() const { return lineNumber_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        struct Chunk : JsonLinesBlock<T>
+        {
+            size_t begin;
+            size_t end;
+
+            Chunk(size_t b, size_t e) : begin(b), end(e) {}
+        };
+
+        void Split()
+        {
+            chunks_.clear();
+            size_t chunkSize = options_.chunkSize > 0 ? options_.chunkSize : 1;
+            size_t begin = 0;
+            while (begin < size_)
+            {
+                size_t end = size_;
+                if (size_ - begin > chunkSize)
+                {
+                    const char *found = static_cast<const char *>(std::memchr(data_ + begin + chunkSize - 1, '\n', size_ - begin - chunkSize + 1));
+                    if (found)
+                        end = found - data_ + 1;
+                }
+                chunks_.push_back(Chunk(begin, end));
+                begin = end;
+            }
+        }
+
+        /**
+         * Chunks are decoded ahead of func by at most maxChunks,
+         * and handed over in order on the calling thread.
+         */
+        template <typename FUNC>
+        void DecodeOrdered(FUNC &func)
+        {
+            size_t window = options_.maxChunks > 0 ? options_.maxChunks : 2 * options_.GetThreads();
+            size_t lineBase = 0;
+            JsonParallel::ForOrdered(
+                options_, chunks_.size(), window,
+                [this](size_t index) {
+                    Chunk &chunk = chunks_[index];
+                    JsonParseContext context;
+                    chunk.Decode(data_ + chunk.begin, chunk.end - chunk.begin, context, (void (*)(T &))NULL);
+                },
+                [&](size_t index) -> bool {
+                    Chunk &chunk = chunks_[index];
+                    for (size_t j = 0; j < chunk.records.size(); j++)
+                        func(chunk.records[j]);
+                    if (chunk.errorLine > 0)
+                    {
+                        SetError(lineBase + chunk.errorLine, chunk.error);
+                        return false;
+                    }
+                    lineBase += chunk.lineCount;
+                    std::vector<T>().swap(chunk.records);
+                    return true;
+                });
+        }
+
+        template <typename FUNC>
+        void DecodeUnordered(FUNC &func)
+        {
+            std::atomic<bool> stop(false);
+            JsonParallel::For(options_, chunks_.size(), [&](size_t index) {
+                if (stop)
+                    return;
+                Chunk &chunk = chunks_[index];
+                JsonParseContext context;
+                chunk.Decode(data_ + chunk.begin, chunk.end - chunk.begin, context, &func);
+                if (chunk.errorLine > 0)
+                    stop = true;
+            });
+            ReportUnorderedError();
+        }
+
+        void ReportUnorderedError()
+        {
+            for (size_t i = 0; i < chunks_.size(); i++)
+            {
+                if (chunks_[i].errorLine > 0)
+                {
+                    const char *begin = data_ + chunks_[i].begin;
+                    size_t lineBase = std::count(data_, begin, '\n');
+                    SetError(lineBase + chunks_[i].errorLine, chunks_[i].error);
+                    return;
+                }
+            }
+        }
+
+        void SetError(size_t line, const std::string &message)
+        {
+            char prefix[32];
+            std::snprintf(prefix, sizeof(prefix), "line %u: ", (unsigned)line);
+            lineNumber_ = line;
+            errorMessage_ = prefix + message;
+            hasError_ = true;
+        }
+
+        const char *data_;
+        size_t size_;
+        JsonParallelOptions options_;
+        std::vector<Chunk> chunks_;
+        bool hasError_;
+        size_t lineNumber_;
+        std::string errorMessage_;
+    };
+
+    /******************************************************
+     * Decode a large top-level json array held in memory on
+     * several threads. One structural scan over brackets,
+     * braces and strings finds the elements, which are then
+     * decoded in parallel straight into a pre-sized vector.
+     * eg:
+     *      std::vector<Test> tests;
+     *      aigc::JsonArrayParallelReader<Test> reader(data, size);
+     *      reader.Read(tests);
+     ******************************************************/
+    template <typename T>
+    class JsonArrayParallelReader
+    {
+    public:
+        JsonArrayParallelReader(const char *data, size_t size, const JsonParallelOptions &options = JsonParallelOptions())
+            : data_(data), size_(size), options_(options), hasError_(false), errorIndex_(0) {}
+
+        bool Read(std::vector<T> &obj)
+        {
+            obj.clear();
+            hasError_ = false;
+            errorMessage_ = "";
+            if (!Scan())
+                return false;
+
+            obj.resize(ranges_.size());
+            if (ranges_.empty())
+                return true;
+
+            // Hand out elements in batches of about chunkSize bytes
+            size_t average = size_ / ranges_.size() + 1;
+            batch_ = options_.chunkSize > average ? options_.chunkSize / average : 1;
+            firstError_ = ranges_.size();
+
+            size_t batches = (ranges_.size() + batch_ - 1) / batch_;
+            JsonParallel::For(options_, batches, [&](size_t index) { Decode(obj, index); });
+
+            if (firstError_ < ranges_.size())
+            {
+                SetError(firstError_, errors_[firstError_]);
+                obj.clear();
+                return false;
+            }
+            return true;
+        }
+
+        bool HasError() const { return hasError_; }
+
+        // Index of the failed element
+        size_t GetIndex() const { return errorIndex_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+
+            Range(size_t b, size_t e) : begin(b), end(e) {}
+        };
+
+        static bool IsSpace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        /**
+         * Find the elements of the top-level array. Elements are
+         * not validated here, that is left to their own parse.
+         */
+        bool Scan()
+        {
+            ranges_.clear();
+            size_t i = 0;
+            while (i < size_ && IsSpace(data_[i]))
+                i++;
+            if (i == size_ || data_[i] != '[')
+                return SetError(0, "json is not an array");
+
+            size_t depth = 1;
+            size_t begin = ++i;
+            for (; i < size_ && depth > 0; i++)
+            {
+                switch (data_[i])
+                {
+                case '"':
+                    for (i++; i < size_ && data_[i] != '"'; i++)
+                    {
+                        if (data_[i] == '\\')
+                            i++;
+                    }
+                    break;
+                case '[':
+                case '{':
+                    depth++;
+                    break;
+                case '}':
+                    depth--;
+                    break;
+                case ']':
+                    if (--depth == 0 && !(ranges_.empty() && IsBlank(begin, i)))
+                        ranges_.push_back(Range(begin, i));
+                    break;
+                case ',':
+                    if (depth == 1)
+                    {
+                        ranges_.push_back(Range(begin, i));
+                        begin = i + 1;
+                    }
+                    break;
+                }
+            }
+
+            if (depth > 0)
+                return SetError(ranges_.size(), "json array is not closed");
+            if (!IsBlank(i, size_))
+                return SetError(ranges_.size(), "unexpected data after json array");
+            return true;
+        }
+
+        bool IsBlank(size_t begin, size_t end) const
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (!IsSpace(data_[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        void Decode(std::vector<T> &obj, size_t index)
+        {
+            size_t begin = index * batch_;
+            if (begin > firstError_)
+                return;
+
+            JsonParseContext context;
+            size_t end = std::min(begin + batch_, ranges_.size());
+            for (size_t i = begin; i < end; i++)
+            {
+                const Range &range = ranges_[i];
+                JsonDocument &root = context.Parse(data_ + range.begin, range.end - range.begin);
+                if (context.HasParseError())
+                    return RecordError(i, context.GetErrorMessage());
+                if (!JsonHelper::JsonValueToObject(obj[i], root, data_ + range.begin, range.end - range.begin))
+                    return RecordError(i, "conver json to object failed");
+            }
+        }
+
+        // Keeps the error of the first failed element
+        void RecordError(size_t index, const std::string &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            errors_[index] = message;
+            if (index < firstError_)
+                firstError_ = index;
+        }
+
+        bool SetError(size_t index, const std::string &message)
+        {
+            char prefix[32];
+            std::snprintf(prefix, sizeof(prefix), "element %u: ", (unsigned)index);
+            errorIndex_ = index;
+            errorMessage_ = prefix + message;
+            hasError_ = true;
+            return false;
+        }
+
+        const char *data_;
+        size_t size_;
+        JsonParallelOptions options_;
+        std::vector<Range> ranges_;
+        size_t batch_;
+        std::atomic<size_t> firstError_;
+        std::mutex mutex_;
+        std::map<size_t, std::string> errors_;
+        bool hasError_;
+        size_t errorIndex_;
+        std::string errorMessage_;
+    };
+
+    /******************************************************
+     * Write a large vector as a json array on several threads.
+     * Batches of elements are written to per-thread buffers
+     * and joined in order with commas and brackets, the output
+     * is the same as ObjectToJson writes.
+     * eg:
+     *      aigc::JsonArrayParallelWriter<Test> writer;
+     *      writer.Write(tests, stream);
+     ******************************************************/
+    template <typename T>
+    class JsonArrayParallelWriter
+    {
+    public:
+        explicit JsonArrayParallelWriter(const JsonParallelOptions &options = JsonParallelOptions())
+            : options_(options) {}
+
+        bool Write(std::vector<T> &obj, JsonOutputStream &stream)
+        {
+            stream.Put('[');
+            if (!obj.empty() && !WriteElements(obj, stream))
+            {
+                stream.Flush();
+                return false;
+            }
+            stream.Put(']');
+            stream.Flush();
+            return stream.Good();
+        }
+
+        bool Write(std::vector<T> &obj, std::string &jsonStr)
+        {
+            std::string ret;
+            JsonStringOutputStream stream(ret);
+            if (!Write(obj, stream))
+                return false;
+
+            jsonStr.swap(ret);
+            return true;
+        }
+
+    private:
+        struct Batch
+        {
+            std::string data;
+            bool failed;
+
+            Batch() : failed(false) {}
+        };
+
+        bool WriteElements(std::vector<T> &obj, JsonOutputStream &stream)
+        {
+            // The first element tells how many elements make up a batch
+            std::string first;
+            if (!EncodeElements(obj, 0, 1, first))
+                return false;
+            size_t batch = options_.chunkSize > first.size() ? options_.chunkSize / (first.size() + 1) : 1;
+
+            std::vector<Batch> batches((obj.size() + batch - 1) / batch);
+            size_t window = options_.maxChunks > 0 ? options_.maxChunks : 2 * options_.GetThreads();
+            bool check = JsonParallel::ForOrdered(
+                options_, batches.size(), window,
+                [&](size_t index) {
+                    size_t begin = index * batch;
+                    size_t end = std::min(begin + batch, obj.size());
+                    batches[index].failed = !EncodeElements(obj, begin, end, batches[index].data);
+                },
+                [&](size_t index) -> bool {
+                    Batch &current = batches[index];
+                    if (current.failed)
+                        return false;
+                    stream.Write(current.data.data(), current.data.size());
+                    std::string().swap(current.data);
+                    return true;
+                });
+            return check && stream.Good();
+        }
+
+        // Elements after the first one are preceded by a comma
+        static bool EncodeElements(std::vector<T> &obj, size_t begin, size_t end, std::string &data)
+        {
+            JsonStringOutputStream stream(data);
+            JsonWriter writer(stream);
+            for (size_t i = begin; i < end; i++)
+            {
+                if (i > 0)
+                    stream.Put(',');
+                writer.Reset(stream);
+                if (!JsonHelper::ObjectToJsonWriter(obj[i], writer))
+                    return false;
+            }
+            stream.Flush();
+            return true;
+        }
+
+        JsonParallelOptions options_;
+    };
+
+    /******************************************************
+     * Bounded lock-free queue for many producers and many
+     * consumers (Dmitry Vyukov's array queue). TryPush and
+     * TryPop never block, they fail when the queue is full
+     * or empty. The capacity is rounded up to a power of two.
+     ******************************************************/
+    template <typename T>
+    class JsonBoundedQueue
+    {
+    public:
+        explicit JsonBoundedQueue(size_t capacity) : enqueue_(0), dequeue_(0)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size *= 2;
+            cells_.reset(new Cell[size]);
+            mask_ = size - 1;
+            for (size_t i = 0; i < size; i++)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool TryPush(const T &value)
+        {
+            size_t position = enqueue_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell &cell = cells_[position & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+                if (diff == 0)
+                {
+                    if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = value;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+
+        bool TryPop(T &value)
+        {
+            size_t position = dequeue_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell &cell = cells_[position & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)sequence - (intptr_t)(position + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        value = cell.value;
+                        cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    position = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        JsonBoundedQueue(const JsonBoundedQueue &);
+        JsonBoundedQueue &operator=(const JsonBoundedQueue &);
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        // Keeps the two ends on cache lines of their own
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+        char padding0_[64];
+        std::atomic<size_t> enqueue_;
+        char padding1_[64];
+        std::atomic<size_t> dequeue_;
+    };
+
+    /******************************************************
+     * Counters of a JsonLinesPipeline run. A stage stalls
+     * when it has to wait for another one:
+     *      read    : waits for a free buffer, the stages after
+     *                it are slower
+     *      decode  : waits for a read buffer, reading is slower
+     *      consume : waits for a decoded buffer, decoding is
+     *                slower
+     * The stage that stalls least is the bottleneck.
+     ******************************************************/
+    struct JsonPipelineStats
+    {
+        struct Stage
+        {
+            size_t blocks;
+            size_t bytes;
+            size_t records;
+            size_t stalls;
+            double stallSeconds;
+            double busySeconds;
+
+            Stage() : blocks(0), bytes(0), records(0), stalls(0), stallSeconds(0), busySeconds(0) {}
+
+            // Bytes per second while not stalled
+            double GetThroughput() const { return busySeconds > 0 ? bytes / busySeconds : 0; }
+        };
+
+        Stage read;
+        Stage decode;
+        Stage consume;
+        double seconds;
+
+        JsonPipelineStats() : seconds(0) {}
+    };
+
+    /******************************************************
+     * Read, decode and consume json lines at the same time:
+     * a reader thread fills buffers from the stream, decoder
+     * threads turn them into records and the calling thread
+     * hands the records over. Buffers go round through
+     * bounded lock-free queues and are reused, so a slow
+     * stage holds the others back instead of using more
+     * memory. The options are used as:
+     *      threads   : decoder threads, 0 for the concurrency
+     *                  of the executor
+     *      chunkSize : buffer size, a buffer grows when one
+     *                  line does not fit
+     *      maxChunks : buffers, 0 for twice the decoders
+     *      ordered   : hand records over in input order
+     * The stages wait on their queues all along, so they run
+     * on threads of their own rather than on the executor.
+     * eg:
+     *      aigc::JsonFdInputStream stream(fd);
+     *      aigc::JsonLinesPipeline<Test> pipeline(stream);
+     *      pipeline.Run([](Test &test) { ... });
+     *      pipeline.GetStats();
+     ******************************************************/
+    template <typename T>
+    class JsonLinesPipeline
+    {
+    public:
+        explicit JsonLinesPipeline(JsonInputStream &stream, const JsonParallelOptions &options = JsonParallelOptions())
+            : stream_(stream), options_(options), hasError_(false), lineNumber_(0) {}
+
+        /**
+         * @brief read and decode the whole stream
+         * @param func : called as func(T &) for each record, on the
+         *               calling thread
+         */
+        template <typename FUNC>
+        bool Run(FUNC func)
+        {
+            hasError_ = false;
+            errorMessage_ = "";
+            lineNumber_ = 0;
+            stats_ = JsonPipelineStats();
+            carry_.clear();
+            linesRead_ = 0;
+            blocksRead_ = 0;
+            readerDone_ = false;
+            stop_ = false;
+            threadError_ = std::exception_ptr();
+
+            size_t decoders = options_.GetThreads();
+            size_t blockCount = options_.maxChunks > 0 ? options_.maxChunks : 2 * decoders;
+            blockCount = std::max<size_t>(blockCount, 2);
+            blocks_.clear();
+            blocks_.resize(blockCount);
+            freeQueue_.reset(new JsonBoundedQueue<Block *>(blockCount));
+            readQueue_.reset(new JsonBoundedQueue<Block *>(blockCount));
+            decodedQueue_.reset(new JsonBoundedQueue<Block *>(blockCount));
+            for (size_t i = 0; i < blockCount; i++)
+                freeQueue_->TryPush(&blocks_[i]);
+
+            Clock::time_point start = Clock::now();
+            {
+                Threads threads(*this);
+                threads.list.push_back(std::thread(&JsonLinesPipeline::Read, this));
+                for (size_t i = 0; i < decoders; i++)
+                    threads.list.push_back(std::thread(&JsonLinesPipeline::Decode, this));
+                Consume(func);
+            }
+            stats_.seconds = Seconds(start);
+            stats_.read.busySeconds = stats_.seconds - stats_.read.stallSeconds;
+            stats_.decode.busySeconds = stats_.seconds * decoders - stats_.decode.stallSeconds;
+            stats_.consume.busySeconds = stats_.seconds - stats_.consume.stallSeconds;
+
+            if (threadError_)
+                std::rethrow_exception(threadError_);
+            return !hasError_;
+        }
+
+        const JsonPipelineStats &GetStats() const { return stats_; }
+
+        bool HasError() const { return hasError_; }
+
+        // Line of the error
+        size_t GetLineNumber() const { return lineNumber_; }
+
+        std::string GetErrorMessage() const { return errorMessage_; }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Block : JsonLinesBlock<T>
+        {
+            std::vector<char> data;
+            size_t size;
+            size_t sequence;
+            size_t firstLine;
+
+            Block() : size(0), sequence(0), firstLine(0) {}
+        };
+
+        // Stops and joins the stages on every exit, eg. when func throws
+        struct Threads
+        {
+            JsonLinesPipeline &owner;
+            std::vector<std::thread> list;
+
+            explicit Threads(JsonLinesPipeline &pipeline) : owner(pipeline) {}
+
+            ~Threads()
+            {
+                owner.stop_ = true;
+                for (size_t i = 0; i < list.size(); i++)
+                    list[i].join();
+            }
+        };
+
+        static double Seconds(Clock::time_point start)
+        {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        /**
+         * Retry op until it succeeds, spinning first and then
+         * sleeping. Returns false when the pipeline stops.
+         */
+        template <typename OP>
+        bool Wait(OP op, JsonPipelineStats::Stage &stage)
+        {
+            if (op())
+                return true;
+
+            Clock::time_point start = Clock::now();
+            stage.stalls++;
+            for (unsigned spins = 0; !op(); spins++)
+            {
+                if (stop_)
+                    return false;
+                if (spins < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            stage.stallSeconds += Seconds(start);
+            return true;
+        }
+
+        void Read()
+        {
+            try
+            {
+                while (!stop_)
+                {
+                    Block *block = NULL;
+                    if (!Wait([&]() { return freeQueue_->TryPop(block); }, stats_.read))
+                        break;
+                    if (!Fill(*block))
+                        break;
+
+                    block->sequence = blocksRead_;
+                    block->firstLine = linesRead_;
+                    linesRead_ += std::count(&block->data[0], &block->data[0] + block->size, '\n');
+                    stats_.read.blocks++;
+                    stats_.read.bytes += block->size;
+                    readQueue_->TryPush(block);
+                    blocksRead_++;
+                }
+            }
+            catch (...)
+            {
+                Fail(std::current_exception());
+            }
+            readerDone_ = true;
+        }
+
+        /**
+         * Fill a block with whole lines, the part of the last line
+         * that does not fit is carried over to the next block.
+         */
+        bool Fill(Block &block)
+        {
+            size_t blockSize = options_.chunkSize > 0 ? options_.chunkSize : 1;
+            std::vector<char> &data = block.data;
+            if (data.size() < std::max(blockSize, carry_.size() + 1))
+                data.resize(std::max(blockSize, carry_.size() * 2));
+            if (!carry_.empty())
+                std::memcpy(&data[0], carry_.data(), carry_.size());
+            size_t size = carry_.size();
+            carry_.clear();
+
+            while (true)
+            {
+                while (size < data.size() && stream_.Fill())
+                {
+                    size_t count = std::min(stream_.Available(), data.size() - size);
+                    std::memcpy(&data[size], stream_.Current(), count);
+                    stream_.Skip(count);
+                    size += count;
+                }
+                if (size < data.size())
+                {
+                    block.size = size;
+                    return size > 0;
+                }
+
+                size_t end = size;
+                while (end > 0 && data[end - 1] != '\n')
+                    end--;
+                if (end > 0)
+                {
+                    carry_.assign(data.begin() + end, data.begin() + size);
+                    block.size = end;
+                    return true;
+                }
+                // One line longer than the block
+                data.resize(data.size() * 2);
+            }
+        }
+
+        void Decode()
+        {
+            JsonPipelineStats::Stage stage;
+            try
+            {
+                JsonParseContext context;
+                while (!stop_)
+                {
+                    // Pop before looking at the queue again once the reader is done
+                    Block *block = NULL;
+                    auto popped = [&]() {
+                        bool done = readerDone_;
+                        return readQueue_->TryPop(block) || done;
+                    };
+                    if (!Wait(popped, stage) || !block)
+                        break;
+
+                    block->Decode(&block->data[0], block->size, context, (void (*)(T &))NULL);
+                    stage.blocks++;
+                    stage.bytes += block->size;
+                    stage.records += block->records.size();
+                    decodedQueue_->TryPush(block);
+                }
+            }
+            catch (...)
+            {
+                Fail(std::current_exception());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.decode.blocks += stage.blocks;
+            stats_.decode.bytes += stage.bytes;
+            stats_.decode.records += stage.records;
+            stats_.decode.stalls += stage.stalls;
+            stats_.decode.stallSeconds += stage.stallSeconds;
+        }
+
+        /**
+         * Blocks are put back in order through slots indexed by
+         * their sequence, at most one block per slot is in flight.
+         */
+        template <typename FUNC>
+        void Consume(FUNC &func)
+        {
+            std::vector<Block *> slots(blocks_.size(), (Block *)NULL);
+            size_t next = 0;
+            while (!stop_)
+            {
+                Block *block = NULL;
+                auto popped = [&]() {
+                    bool done = readerDone_;
+                    if (options_.ordered && slots[next % slots.size()])
+                        return true;
+                    Block *decoded = NULL;
+                    if (decodedQueue_->TryPop(decoded))
+                    {
+                        if (!options_.ordered)
+                        {
+                            block = decoded;
+                            return true;
+                        }
+                        slots[decoded->sequence % slots.size()] = decoded;
+                        return slots[next % slots.size()] != NULL;
+                    }
+                    return done && next == blocksRead_;
+                };
+                if (!Wait(popped, stats_.consume))
+                    break;
+                if (options_.ordered)
+                    std::swap(block, slots[next % slots.size()]);
+                if (!block)
+                    break;
+
+                for (size_t i = 0; i < block->records.size(); i++)
+                    func(block->records[i]);
+                stats_.consume.blocks++;
+                stats_.consume.bytes += block->size;
+                stats_.consume.records += block->records.size();
+                if (block->errorLine > 0)
+                {
+                    SetError(block->firstLine + block->errorLine, block->error);
+                    stop_ = true;
+                    break;
+                }
+                next++;
+                freeQueue_->TryPush(block);
+            }
+        }
+
+        void Fail(std::exception_ptr error)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!threadError_)
+                threadError_ = error;
+            stop_ = true;
+        }
+
+        void SetError(size_t line, const std::string &message)
+        {
+            char prefix[32];
+            std::snprintf(prefix, sizeof(prefix), "line %u: ", (unsigned)line);
+            lineNumber_ = line;
+            errorMessage_ = prefix + message;
+            hasError_ = true;
+        }
+
+        JsonInputStream &stream_;
+        JsonParallelOptions options_;
+        std::vector<Block> blocks_;
+        std::unique_ptr<JsonBoundedQueue<Block *>> freeQueue_;
+        std::unique_ptr<JsonBoundedQueue<Block *>> readQueue_;
+        std::unique_ptr<JsonBoundedQueue<Block *>> decodedQueue_;
+        std::string carry_;
+        size_t linesRead_;
+        std::atomic<size_t> blocksRead_;
+        std::atomic<bool> readerDone_;
+        std::atomic<bool> stop_;
+        std::mutex mutex_;
+        std::exception_ptr threadError_;
+        JsonPipelineStats stats_;
+        bool hasError_;
+        size_t lineNumber_;
+        std::string errorMessage_;
     };
 } // namespace aigc
@@ -0,0 +1,38 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Point
+{
+public:
+    string Name;
+    double X;
+    double Y;
+
+    AIGC_JSON_HELPER(Name, X, Y)
+};
+
+int main()
+{
+    string points = R"([{"Name": "A", "X": 1.5, "Y": 2.0},
+                        {"Name": "B", "X": 3.0, "Y": 4.5},
+                        {"Name": "C", "X": 0.5, "Y": 1.0}])";
+
+    JsonMemoryInputStream stream(points.data(), points.size());
+    JsonArrayReader<Point> reader(stream);
+    Point point;
+    double sum = 0;
+    while (reader.Next(point))
+        sum += point.X;
+
+    JsonMemoryInputStream numbers("[1, 2, 3, 4]", 12);
+    JsonArrayReader<int> numberReader(numbers);
+    bool check = numberReader.ForEach([&](int &number) { sum += number; });
+
+    //members missing from an element are reset, the second one has no Name
+    string partial = R"([{"Name": "C", "X": 0.5, "Y": 1.0}, {"X": 2.0, "Y": 3.0}])";
+    JsonMemoryInputStream partialStream(partial.data(), partial.size());
+    JsonArrayReader<Point> partialReader(partialStream);
+    check = partialReader.ForEach([](Point &point) { printf("[%s] %g %g\n", point.Name.c_str(), point.X, point.Y); });
+    return 0;
+}
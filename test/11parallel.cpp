@@ -0,0 +1,46 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Event
+{
+public:
+    string Type;
+    int64_t Time;
+
+    AIGC_JSON_HELPER(Type, Time)
+};
+
+int main()
+{
+    string lines;
+    for (int i = 0; i < 1000; i++)
+        lines += R"({"Type": "login", "Time": )" + to_string(1600000000 + i) + "}\n";
+
+    JsonParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 4096;
+
+    int64_t last = 0;
+    JsonLinesParallelReader<Event> reader(lines.data(), lines.size(), options);
+    bool check = reader.ForEach([&](Event &event) { last = event.Time; });
+
+    options.ordered = false;
+    atomic<int> count(0);
+    JsonLinesParallelReader<Event> unorderedReader(lines.data(), lines.size(), options);
+    check = unorderedReader.ForEach([&](Event &event) { count++; });
+
+    //members missing from a line are reset in both modes, 100 pings without Time
+    string partial;
+    for (int i = 0; i < 1000; i++)
+        partial += i % 10 ? R"({"Type": "login", "Time": 1})" "\n" : R"({"Type": "ping"})" "\n";
+    for (int ordered = 0; ordered < 2; ordered++)
+    {
+        options.ordered = ordered != 0;
+        atomic<int> pings(0);
+        JsonLinesParallelReader<Event> partialReader(partial.data(), partial.size(), options);
+        check = partialReader.ForEach([&](Event &event) { pings += event.Time == 0; });
+        printf("%s %d\n", options.ordered ? "ordered" : "unordered", pings.load());
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Point
+{
+public:
+    string Name;
+    double X;
+    double Y;
+
+    AIGC_JSON_HELPER(Name, X, Y)
+};
+
+int main()
+{
+    string points = "[";
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i > 0)
+            points += ",";
+        points += R"({"Name": "P)" + to_string(i) + R"(", "X": 1.5, "Y": 2.5})";
+    }
+    points += "]";
+
+    JsonParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 4096;
+
+    vector<Point> result;
+    JsonArrayParallelReader<Point> reader(points.data(), points.size(), options);
+    bool check = reader.Read(result);
+    return 0;
+}
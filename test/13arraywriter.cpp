@@ -0,0 +1,36 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Point
+{
+public:
+    string Name;
+    double X;
+    double Y;
+
+    AIGC_JSON_HELPER(Name, X, Y)
+};
+
+int main()
+{
+    vector<Point> points(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        points[i].Name = "P" + to_string(i);
+        points[i].X = 1.5;
+        points[i].Y = 2.5;
+    }
+
+    JsonParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 4096;
+
+    string jsonStr;
+    JsonArrayParallelWriter<Point> writer(options);
+    bool check = writer.Write(points, jsonStr);
+
+    JsonFileOutputStream stream(stdout);
+    check = writer.Write(points, stream);
+    return 0;
+}
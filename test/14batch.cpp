@@ -0,0 +1,31 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Message
+{
+public:
+    string Topic;
+    int64_t Offset;
+
+    AIGC_JSON_HELPER(Topic, Offset)
+    AIGC_JSON_HELPER_RENAME("topic", "offset")
+};
+
+int main()
+{
+    vector<string> payloads;
+    for (int i = 0; i < 1000; i++)
+        payloads.push_back(R"({"topic": "orders", "offset": )" + to_string(i) + "}");
+
+    vector<Message> messages;
+    bool check = JsonHelper::JsonToObjects(messages, payloads);
+
+    JsonParallelOptions options;
+    options.threads = 4;
+    check = JsonHelper::JsonToObjects(messages, payloads, options);
+
+    vector<string> jsonStrs;
+    check = JsonHelper::ObjectsToJson(messages, jsonStrs, options);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Point
+{
+public:
+    string Name;
+    double X;
+    double Y;
+
+    AIGC_JSON_HELPER(Name, X, Y)
+};
+
+int main()
+{
+    string lines;
+    for (int i = 0; i < 1000; i++)
+        lines += R"({"Name": "P)" + to_string(i) + R"(", "X": 1.5, "Y": 2.5})" + "\n";
+
+    //All parallel apis share one pool, pinned to the cores
+    JsonThreadPool pool(4, true);
+    JsonParallelOptions options;
+    options.executor = &pool;
+    options.chunkSize = 4096;
+
+    vector<Point> points;
+    JsonLinesParallelReader<Point> reader(lines.data(), lines.size(), options);
+    bool check = reader.ForEach([&](Point &point) { points.push_back(point); });
+
+    string jsonStr;
+    JsonArrayParallelWriter<Point> writer(options);
+    check = writer.Write(points, jsonStr);
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "AIGCJson.hpp"
+#include <sstream>
+using namespace std;
+using namespace aigc;
+
+class Event
+{
+public:
+    string Type;
+    int64_t Time;
+
+    AIGC_JSON_HELPER(Type, Time)
+};
+
+int main()
+{
+    string lines;
+    for (int i = 0; i < 1000; i++)
+        lines += R"({"Type": "login", "Time": )" + to_string(i) + "}\n";
+    istringstream is(lines);
+
+    JsonParallelOptions options;
+    options.threads = 2;
+    options.chunkSize = 4096;
+
+    //Read, decode and consume at the same time
+    JsonIStreamInputStream stream(is);
+    JsonLinesPipeline<Event> pipeline(stream, options);
+    int64_t count = 0;
+    bool check = pipeline.Run([&](Event &event) { count++; });
+
+    //Which stage waited the least is the slowest one
+    const JsonPipelineStats &stats = pipeline.GetStats();
+    cout << "read stalls: " << stats.read.stalls
+         << ", decode stalls: " << stats.decode.stalls
+         << ", consume stalls: " << stats.consume.stalls << endl;
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Event
+{
+public:
+    string Type;
+    int64_t Time;
+
+    AIGC_JSON_HELPER(Type, Time)
+};
+
+int main()
+{
+    //Values back to back
+    string concatenated = R"({"Type": "login", "Time": 1}{"Type": "logout", "Time": 2})";
+    JsonMemoryInputStream stream(concatenated.data(), concatenated.size());
+    JsonSequenceReader<Event> reader(stream);
+    Event event;
+    while (reader.Next(event))
+        cout << event.Type << " " << event.Time << endl;
+
+    //RFC 7464 json text sequence
+    string sequence = "\x1e" R"({"Type": "login", "Time": 3})" "\n"
+                      "\x1e" R"({"Type": "logout", "Time": 4})" "\n";
+    JsonMemoryInputStream seqStream(sequence.data(), sequence.size());
+    JsonSequenceReader<Event> seqReader(seqStream);
+    bool check = seqReader.ForEach([](Event &event) { cout << event.Type << " " << event.Time << endl; });
+
+    //members missing from a value are reset, the ping has no Time
+    string partial = R"({"Type": "login", "Time": 5} {"Type": "ping"})";
+    JsonMemoryInputStream partialStream(partial.data(), partial.size());
+    JsonSequenceReader<Event> partialReader(partialStream);
+    check = partialReader.ForEach([](Event &event) { cout << event.Type << " " << event.Time << endl; });
+    return 0;
+}
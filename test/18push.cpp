@@ -0,0 +1,32 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Student
+{
+public:
+    string Name;
+    int Age;
+    vector<string> Courses;
+
+    AIGC_JSON_HELPER(Name, Age, Courses)
+};
+
+int main()
+{
+    string jsonStr = R"({"Name": "XiaoMing", "Age": 15, "Courses": ["math", "art"]})"
+                     R"({"Name": "XiaoHong", "Age": 16, "Courses": []})";
+
+    //Data comes in chunks cut anywhere, eg. from a socket
+    JsonPushDecoder<Student> decoder;
+    Student student;
+    for (size_t i = 0; i < jsonStr.size(); i += 7)
+    {
+        if (!decoder.Feed(jsonStr.data() + i, min<size_t>(7, jsonStr.size() - i)))
+            break;
+        while (decoder.Next(student))
+            cout << student.Name << " " << student.Age << endl;
+    }
+    bool check = decoder.Finish();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "AIGCJson.hpp"
+#include <deque>
+using namespace std;
+using namespace aigc;
+
+#if AIGC_JSON_HAS_COROUTINES
+class Student
+{
+public:
+    string Name;
+    int Age;
+
+    AIGC_JSON_HELPER(Name, Age)
+};
+
+//Event loop running the coroutines that wait for data
+struct EventLoop
+{
+    deque<coroutine_handle<>> ready;
+
+    void Run()
+    {
+        while (!ready.empty())
+        {
+            coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            handle.resume();
+        }
+    }
+};
+
+//In-memory async source, every read waits for the loop once
+struct MemorySource
+{
+    EventLoop &loop;
+    string data;
+    size_t position;
+
+    struct ReadAwaiter
+    {
+        MemorySource &source;
+        char *buffer;
+        size_t size;
+
+        bool await_ready() { return false; }
+        void await_suspend(coroutine_handle<> handle) { source.loop.ready.push_back(handle); }
+        size_t await_resume()
+        {
+            size_t count = min(size, source.data.size() - source.position);
+            memcpy(buffer, source.data.data() + source.position, count);
+            source.position += count;
+            return count;
+        }
+    };
+
+    ReadAwaiter Read(char *buffer, size_t size) { return ReadAwaiter{*this, buffer, size}; }
+};
+
+//Async sink printing what is written
+struct PrintSink
+{
+    bool await_ready() { return true; }
+    void await_suspend(coroutine_handle<>) {}
+    bool await_resume() { return true; }
+
+    PrintSink &Write(const char *data, size_t size)
+    {
+        cout.write(data, size);
+        return *this;
+    }
+};
+
+JsonTask<bool> Replay(MemorySource &source)
+{
+    JsonAsyncReader<Student, MemorySource> reader(source, 16);
+    vector<Student> students;
+    Student student;
+    while (co_await reader.Next(student))
+        students.push_back(student);
+
+    PrintSink sink;
+    if (!co_await JsonAsync::ArrayToJson(students, sink))
+        co_return false;
+
+    //encoded a few bytes at a time between writes
+    co_return co_await JsonAsync::ObjectToJson(students[0], sink, 8);
+}
+
+int main()
+{
+    EventLoop loop;
+    MemorySource source{loop, R"({"Name": "XiaoMing", "Age": 15} {"Name": "XiaoHong", "Age": 16})", 0};
+    JsonTask<bool> task = Replay(source);
+    task.Start();
+    loop.Run();
+    bool check = task.Get();
+    return 0;
+}
+#else
+int main()
+{
+    //Coroutines need c++20
+    return 0;
+}
+#endif
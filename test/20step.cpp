@@ -0,0 +1,56 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Point
+{
+public:
+    string Name;
+    vector<double> Values;
+
+    AIGC_JSON_HELPER(Name, Values)
+};
+
+class Report
+{
+public:
+    string Title;
+    vector<Point> Points;
+
+    AIGC_JSON_HELPER(Title, Points)
+};
+
+int main()
+{
+    Report report;
+    report.Title = "report";
+    report.Points.resize(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        report.Points[i].Name = "P" + to_string(i);
+        report.Points[i].Values.assign(8, i * 0.5);
+    }
+
+    string jsonStr;
+    JsonStringOutputStream stream(jsonStr);
+    JsonStepEncoder encoder(report, stream);
+    while (!encoder.IsDone())
+    {
+        //at most about 4KB per step
+        if (!encoder.Step(4096))
+            break;
+        printf("%zu\n", jsonStr.size());
+        jsonStr.clear();
+    }
+
+    //or at most 100us per step
+    string timedStr;
+    JsonStringOutputStream timedStream(timedStr);
+    JsonStepEncoder timedEncoder(report, timedStream);
+    while (!timedEncoder.IsDone())
+    {
+        if (!timedEncoder.Step(chrono::microseconds(100)))
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Detail
+{
+public:
+    string Name;
+    vector<int> Scores;
+
+    AIGC_JSON_HELPER(Name, Scores)
+};
+
+class Message
+{
+public:
+    string Type;
+    Lazy<Detail> Body;
+
+    AIGC_JSON_HELPER(Type, Body)
+};
+
+int main()
+{
+    Message message;
+    JsonHelper::JsonToObject(message, R"({"Type":"score", "Body":{"Name":"XiaoMing", "Scores":[90, 85]}})");
+
+    //Body is not decoded yet, it is written back as it was
+    string jsonStr;
+    JsonHelper::ObjectToJson(message, jsonStr);
+
+    //decoded on first access
+    string name = message.Body->Name;
+    bool check = message.Body.Load();
+
+    message.Body->Scores.push_back(100);
+    JsonHelper::ObjectToJson(message, jsonStr);
+
+    //a null member loads as a default Detail
+    JsonHelper::JsonToObject(message, R"({"Type":"empty", "Body":null})");
+    check = message.Body.Load();
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Envelope
+{
+public:
+    string Topic;
+    RawJson Payload;
+
+    AIGC_JSON_HELPER(Topic, Payload)
+};
+
+int main()
+{
+    Envelope envelope;
+    JsonHelper::JsonToObject(envelope, R"({"Topic":"order", "Payload":{"Id":7, "Price":1e2, "Items":[1, 2, 3]}})");
+
+    //the payload keeps its source bytes
+    //{"Topic":"order","Payload":{"Id":7, "Price":1e2, "Items":[1, 2, 3]}}
+    string jsonStr;
+    JsonHelper::ObjectToJson(envelope, jsonStr);
+    printf("%s\n", jsonStr.c_str());
+
+    envelope.Payload = RawJson("[true,null]");
+    JsonHelper::ObjectToJson(envelope, jsonStr);
+    printf("%s\n", jsonStr.c_str());
+
+    //not json, nothing is written
+    envelope.Payload = RawJson("{broken");
+    if (!JsonHelper::ObjectToJson(envelope, jsonStr))
+        printf("invalid payload\n");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Request
+{
+public:
+    StringRef Method;
+    StringRef Path;
+    int Id;
+
+    AIGC_JSON_HELPER(Method, Path, Id)
+};
+
+int main()
+{
+    //parsed in place, Method and Path point into buffer
+    char buffer[] = R"({"Method":"GET", "Path":"/index.html", "Id":1})";
+    Request request;
+    bool check = JsonHelper::JsonToObjectInsitu(request, buffer);
+
+    string method = request.Method.ToString();
+    printf("%.*s\n", (int)request.Path.Length(), request.Path.Data());
+
+#if AIGC_JSON_HAS_STRING_VIEW
+    char viewBuffer[] = R"({"Path":"/about.html"})";
+    string_view path;
+    check = JsonHelper::JsonToObjectInsitu(path, viewBuffer, {"Path"});
+#endif
+    return 0;
+}
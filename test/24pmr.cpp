@@ -0,0 +1,46 @@
+#include "AIGCJson.hpp"
+#if defined(__has_include) && __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define HAS_PMR
+#endif
+#endif
+using namespace std;
+using namespace aigc;
+
+#ifdef HAS_PMR
+class Order
+{
+public:
+    typedef pmr::polymorphic_allocator<char> allocator_type;
+
+    //members built on the caller's memory resource
+    Order(allocator_type alloc = {}) : Name(alloc), Items(alloc), Prices(alloc) {}
+
+    pmr::string Name;
+    pmr::vector<pmr::string> Items;
+    pmr::map<pmr::string, double> Prices;
+
+    AIGC_JSON_HELPER(Name, Items, Prices)
+};
+
+int main()
+{
+    //one arena per request, strings and elements decoded into it
+    char buffer[4096];
+    pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+
+    Order order(&arena);
+    bool check = JsonHelper::JsonToObject(order, R"({"Name":"breakfast", "Items":["coffee", "bagel"], "Prices":{"coffee":2.5, "bagel":1.8}})");
+
+    string jsonStr;
+    JsonHelper::ObjectToJson(order, jsonStr);
+    printf("%s\n", jsonStr.c_str());
+    return 0;
+}
+#else
+int main()
+{
+    return 0;
+}
+#endif
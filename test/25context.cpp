@@ -0,0 +1,33 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Ping
+{
+public:
+    int Id;
+    double Time;
+    bool Reply;
+
+    AIGC_JSON_HELPER(Id, Time, Reply)
+};
+
+int main()
+{
+    //small messages parse inside this buffer, no heap allocation
+    char buffer[8 * 1024];
+    JsonParseContext context(buffer, sizeof(buffer));
+
+    const char *messages[] = {
+        R"({"Id":1, "Time":0.5, "Reply":false})",
+        R"({"Id":2, "Time":0.75, "Reply":true})",
+    };
+    for (int i = 0; i < 2; i++)
+    {
+        Ping ping;
+        if (!JsonHelper::JsonToObject(ping, messages[i], strlen(messages[i]), context))
+            printf("%s\n", context.GetErrorMessage().c_str());
+        printf("%d %g\n", ping.Id, ping.Time);
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Event
+{
+public:
+    string Type;
+    int64_t Time;
+    vector<string> Tags;
+    int Retries = 3;
+
+    AIGC_JSON_HELPER(Type, Time, Tags, Retries)
+};
+
+class AdminEvent : public Event
+{
+public:
+    string Role;
+
+    AdminEvent() { Type = "admin"; }
+
+    AIGC_JSON_HELPER(Role)
+    AIGC_JSON_HELPER_BASE((Event *)this)
+};
+
+int main()
+{
+    const char *messages[] = {
+        R"({"Type":"login", "Time":1, "Tags":["web"]})",
+        R"({"Type":"logout", "Time":2, "Retries":0})",
+    };
+
+    for (int i = 0; i < 4; i++)
+    {
+        //objects go back to the pool when the handle goes out of scope,
+        //members missing from the json are reset to their defaults (Tags empty, Retries 3)
+        bool check;
+        JsonObjectPool<Event>::Handle event = JsonObjectPool<Event>::GetObjectByJson(messages[i % 2], &check);
+        printf("%s %lld %zu %d\n", event->Type.c_str(), (long long)event->Time, event->Tags.size(), event->Retries);
+    }
+    printf("pooled %zu\n", JsonObjectPool<Event>::GetPooledCount());
+
+    //base members are reset to their value in a new AdminEvent (Type admin)
+    AdminEvent admin;
+    JsonHelper::JsonToRecycledObject(admin, R"({"Type":"sudo", "Role":"root"})");
+    JsonHelper::JsonToRecycledObject(admin, R"({"Role":"ops"})");
+    printf("%s %s\n", admin.Type.c_str(), admin.Role.c_str());
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Order
+{
+public:
+    int Id;
+    Interned<string> Status;
+    Interned<string> Region;
+
+    AIGC_JSON_HELPER(Id, Status, Region)
+};
+
+int main()
+{
+    vector<Order> orders;
+    JsonHelper::JsonToObject(orders, R"([{"Id":1, "Status":"paid", "Region":"eu"},
+                                         {"Id":2, "Status":"paid", "Region":"us"},
+                                         {"Id":3, "Status":"open", "Region":"eu"}])");
+
+    //one copy of each distinct value, compared by pointer
+    Interned<string> paid("paid");
+    for (size_t i = 0; i < orders.size(); i++)
+    {
+        if (orders[i].Status == paid)
+            printf("%d %s\n", orders[i].Id, orders[i].Region.Get().c_str());
+    }
+    printf("distinct %zu\n", JsonInternTable<string>::GetSize());
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Account
+{
+public:
+    int64_t AccountIdentifier;
+    string AccountDisplayName;
+
+    AIGC_JSON_HELPER(AccountIdentifier, AccountDisplayName)
+};
+
+int main()
+{
+    string jsonStr = "[";
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i > 0)
+            jsonStr += ",";
+        jsonStr += R"({"AccountIdentifier":)" + to_string(i) + R"(, "AccountDisplayName":"user)" + to_string(i) + "\"}";
+    }
+    jsonStr += "]";
+
+    //each key is stored once for the 1000 elements
+    JsonParseContext context;
+    context.SetInternKeys(true);
+
+    vector<Account> accounts;
+    bool check = JsonHelper::JsonToObject(accounts, jsonStr.c_str(), jsonStr.size(), context);
+    printf("%zu accounts, %zu keys\n", accounts.size(), context.GetInternedKeyCount());
+    return 0;
+}
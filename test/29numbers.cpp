@@ -0,0 +1,30 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Series
+{
+public:
+    string Name;
+    vector<double> Values;
+    vector<int> Counts;
+
+    AIGC_JSON_HELPER(Name, Values, Counts)
+};
+
+int main()
+{
+    //numbers are read straight into the vector
+    vector<double> values;
+    bool check = JsonHelper::JsonToObject(values, "[0.5, 1, -2.25, 3e2]");
+    printf("%zu values, check %d\n", values.size(), check);
+
+    Series series;
+    check = JsonHelper::JsonToObject(series, R"({"Name":"cpu", "Values":[0.1, 0.2, 0.3], "Counts":[1, 2, 3]})");
+
+    //numbers are written in one loop
+    string jsonStr;
+    check = JsonHelper::ObjectToJson(series, jsonStr);
+    printf("%s\n", jsonStr.c_str());
+    return 0;
+}
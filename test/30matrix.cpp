@@ -0,0 +1,34 @@
+#include "AIGCJson.hpp"
+using namespace std;
+using namespace aigc;
+
+class Track
+{
+public:
+    string Name;
+    JsonMatrix<double> Points;
+    JsonMatrix<int> Samples;
+
+    //every point is [x,y], samples may differ in length
+    Track() : Points(2) {}
+
+    AIGC_JSON_HELPER(Name, Points, Samples)
+};
+
+int main()
+{
+    Track track;
+    bool check = JsonHelper::JsonToObject(track, R"({"Name":"route", "Points":[[1.5, 2], [3, 4.25], [5, 6]], "Samples":[[1], [2, 3], []]})");
+    printf("%zu points, second y %g, check %d\n", track.Points.GetRowCount(), track.Points[1][1], check);
+
+    //a point of three numbers fails the decoding
+    check = JsonHelper::JsonToObject(track, R"({"Name":"route", "Points":[[1, 2, 3]]})");
+    printf("check %d\n", check);
+
+    string jsonStr;
+    double point[] = {7, 8};
+    track.Points.AddRow(point, 2);
+    check = JsonHelper::ObjectToJson(track, jsonStr);
+    printf("%s\n", jsonStr.c_str());
+    return 0;
+}
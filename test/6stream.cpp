@@ -0,0 +1,42 @@
+#include "AIGCJson.hpp"
+#include <sstream>
+using namespace std;
+using namespace aigc;
+
+class Student
+{
+public:
+    string Name;
+    int Age;
+
+    AIGC_JSON_HELPER(Name, Age)
+};
+
+class Grade
+{
+public:
+    int Level;
+    vector<Student> Students;
+
+    AIGC_JSON_HELPER(Level, Students)
+};
+
+int main()
+{
+    bool check;
+    Grade grade;
+    JsonHelper::JsonToObject(grade, R"({"Level": 3, 
+                                        "Students": [{"Name": "XiaoMing", "Age": 15},
+                                                     {"Name": "XiaoHong", "Age": 14}]})");
+
+    ostringstream os;
+    check = JsonHelper::ObjectToJson(grade, os);
+
+    FILE *fp = tmpfile();
+    check = JsonHelper::ObjectToJson(grade, fp);
+    fclose(fp);
+
+    JsonFdOutputStream stream(1, 4096);
+    check = JsonHelper::ObjectToJson(grade, stream);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include "AIGCJson.hpp"
+#include <fstream>
+using namespace std;
+using namespace aigc;
+
+class Student
+{
+public:
+    string Name;
+    int Age;
+
+    AIGC_JSON_HELPER(Name, Age)
+};
+
+int main()
+{
+    bool check;
+    {
+        ofstream out("7file.json");
+        out << R"({"School": "No.1", "Leader": {"Name": "XiaoMing", "Age": 15}})";
+    }
+
+    Student leader;
+    check = JsonHelper::JsonFileToObject(leader, "7file.json", {"Leader"});
+
+    ifstream in("7file.json");
+    check = JsonHelper::JsonToObject(leader, in, {"Leader"});
+
+    string school;
+    FILE *fp = fopen("7file.json", "rb");
+    check = JsonHelper::JsonToObject(school, fp, {"School"});
+    fclose(fp);
+
+    remove("7file.json");
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include "AIGCJson.hpp"
+#include <fstream>
+using namespace std;
+using namespace aigc;
+
+class Config
+{
+public:
+    string Name;
+    map<string, int> Limits;
+
+    AIGC_JSON_HELPER(Name, Limits)
+};
+
+int main()
+{
+    bool check;
+    {
+        ofstream out("8mmap.json");
+        out << R"({"Name": "server", "Limits": {"connections": 1024, "threads": 16}})";
+    }
+
+    Config config;
+    check = JsonHelper::JsonFileToObject(config, "8mmap.json");
+
+    JsonFileOptions options;
+    options.insitu = false;
+    check = JsonHelper::JsonFileToObject(config, "8mmap.json", options);
+
+    options.useMmap = false;
+    options.bufferSize = 4096;
+    check = JsonHelper::JsonFileToObject(config, "8mmap.json", options);
+
+    remove("8mmap.json");
+    return 0;
+}
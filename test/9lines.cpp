@@ -0,0 +1,47 @@
+#include "AIGCJson.hpp"
+#include <sstream>
+using namespace std;
+using namespace aigc;
+
+class Event
+{
+public:
+    string Type;
+    int64_t Time;
+    map<string, string> Tags;
+
+    AIGC_JSON_HELPER(Type, Time, Tags)
+};
+
+int main()
+{
+    string lines = R"({"Type": "login", "Time": 1600000000, "Tags": {"user": "XiaoMing"}}
+{"Type": "logout", "Time": 1600000100, "Tags": {"user": "XiaoMing"}}
+
+{"Type": "login", "Time": 1600000200, "Tags": {"user": "XiaoHong"}}
+{"Type": "ping"}
+)";
+
+    istringstream is(lines);
+    JsonIStreamInputStream stream(is);
+    JsonLinesReader<Event> reader(stream);
+    Event event;
+    int count = 0;
+    while (reader.Next(event))
+        count++;
+
+    JsonMemoryInputStream memory(lines.data(), lines.size());
+    JsonLinesReader<Event> memoryReader(memory);
+    //members missing from a line are reset, the ping has no Time or Tags
+    bool check = memoryReader.ForEach([&](Event &event) {
+        printf("%s %lld %zu\n", event.Type.c_str(), (long long)event.Time, event.Tags.size());
+        count--;
+    });
+
+    string brokenLines = "{\"Type\": \"login\"}\n{\"Type\": \n";
+    JsonMemoryInputStream broken(brokenLines.data(), brokenLines.size());
+    JsonLinesReader<Event> brokenReader(broken);
+    brokenReader.ForEach([](Event &event) {});
+    string error = brokenReader.GetErrorMessage();
+    return 0;
+}